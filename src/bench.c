@@ -0,0 +1,430 @@
+/**
+ * @file bench.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief A benchmark harness, measuring the throughput and time-to-best of the generators.
+ *
+ * @details This program generates instances of several graph families, starts a number of generators
+ * for each instance and takes the role of the supervisor, reading solutions from the circular buffer
+ * for a fixed time budget. For every run one line of CSV is written to the output file.
+ * Generators only write improvements, so the solutions read per second fall as the best solution improves,
+ * and do not scale with the number of generators. The throughput of the generators is permutations_per_s,
+ * the candidates evaluated per second.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "graph_util.h"
+#include "circular_buffer.h"
+#include "stats.h"
+
+/** the program name */
+static const char *program_name;
+
+/**
+ * @brief a graph family, generating an instance with n vertices.
+ * Returns the optimal feedback arc set size if it is known, otherwise -1.
+ */
+typedef int (*family_fn)(graph *g, int n);
+
+/**
+ * @brief a benchmarked graph family and the instance sizes it is run with.
+ */
+typedef struct family {
+    const char *name;
+    family_fn generate;
+    int sizes[3];
+} family;
+
+/**
+ * @brief the result of one benchmark run.
+ */
+typedef struct result {
+    int best;
+    double time_to_best;
+    double time_to_optimum;
+    double elapsed;
+    unsigned long long improvements;
+    unsigned long long permutations;
+} result;
+
+/**
+ * @brief Prints an error message to stderr, and terminates the program
+ * with EXIT_FAILURE.
+ *
+ * @param message to be printed
+ */
+static void error_and_exit(char *message) {
+    fprintf(stderr, "%s: %s\n", program_name, message);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Prints a usage message to stderr, and terminates the program
+ * with EXIT_FAILURE.
+ */
+static void usage(void) {
+    fprintf(stderr, "usage: %s [-t budget_ms] [-s seed] [-o output] [-g generator]\n", program_name);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Returns a random integer in [0, n).
+ *
+ * @param n the upper bound
+ * @return a random integer
+ */
+static int random_below(int n) {
+    return rand() % n;
+}
+
+/**
+ * @brief Adds the edge u -> v to the graph g, unless it is already contained.
+ *
+ * @param g the graph
+ * @param u vertex u
+ * @param v vertex v
+ */
+static void add_unique(graph *g, int u, int v) {
+    edge e = edge_constr(u, v);
+    if (u != v && graph_contains_edge(g, &e) == 0) {
+        graph_add(g, &e);
+    }
+}
+
+/**
+ * @brief Generates a random DAG with planted back edges.
+ *
+ * @details The vertices are split into k disjoint paths, each closed into a cycle by one back edge.
+ * The cycles are edge disjoint and every other edge points forward in the topological order,
+ * so the minimum feedback arc set consists of exactly the k back edges. The vertices are relabeled
+ * by a random permutation, so the labels do not reveal the order.
+ *
+ * @param g the graph, edges are added to
+ * @param n number of vertices
+ * @return the optimum, k
+ */
+static int planted_dag(graph *g, int n) {
+    int k = n / 5 < MAX_EDGES / 2 ? n / 5 : MAX_EDGES / 2;
+    int len = n / k;
+    int *label = malloc(sizeof(int) * n);
+
+    if (label == NULL) {
+        error_and_exit("error allocating memory");
+    }
+
+    for (int i = 0; i < n; i++) {
+        label[i] = i;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        int j = random_below(i + 1);
+        int tmp = label[i];
+        label[i] = label[j];
+        label[j] = tmp;
+    }
+
+    for (int t = 0; t < k; t++) {
+        int first = t * len;
+        int last = first + len - 1;
+        for (int i = first; i < last; i++) {
+            add_unique(g, label[i], label[i + 1]);
+        }
+        add_unique(g, label[last], label[first]);
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 2; j < n; j++) {
+            if (random_below(n) < 2) {
+                add_unique(g, label[i], label[j]);
+            }
+        }
+    }
+
+    free(label);
+    return k;
+}
+
+/**
+ * @brief Generates a random tournament, every pair of vertices is connected by one edge of random direction.
+ *
+ * @param g the graph, edges are added to
+ * @param n number of vertices
+ * @return -1, the optimum is unknown
+ */
+static int tournament(graph *g, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            if (random_below(2) == 0) {
+                add_unique(g, i, j);
+            } else {
+                add_unique(g, j, i);
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Generates a sparse graph with a power-law degree distribution.
+ *
+ * @details Endpoints are chosen with a probability proportional to 1 / (i + 1),
+ * so a few vertices have a high degree and most have a low one. The graph has about n + n / 4 edges.
+ *
+ * @param g the graph, edges are added to
+ * @param n number of vertices
+ * @return -1, the optimum is unknown
+ */
+static int power_law(graph *g, int n) {
+    double total = 0;
+    for (int i = 0; i < n; i++) {
+        total += 1.0 / (i + 1);
+    }
+
+    for (int k = 0; k < n + n / 4; k++) {
+        int endpoints[2];
+        for (int e = 0; e < 2; e++) {
+            double r = (double) rand() / RAND_MAX * total;
+            int i = 0;
+            while (i < n - 1 && (r -= 1.0 / (i + 1)) > 0) {
+                i++;
+            }
+            endpoints[e] = i;
+        }
+        add_unique(g, endpoints[0], endpoints[1]);
+    }
+    return -1;
+}
+
+/**
+ * @brief Generates a directed grid, where every row and every column is closed into a cycle.
+ *
+ * @param g the graph, edges are added to
+ * @param n number of vertices, rounded down to a square
+ * @return -1, the optimum is unknown
+ */
+static int grid_cycles(graph *g, int n) {
+    int side = 2;
+    while ((side + 1) * (side + 1) <= n) {
+        side++;
+    }
+
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            add_unique(g, r * side + c, r * side + (c + 1) % side);
+            add_unique(g, r * side + c, ((r + 1) % side) * side + c);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the seconds elapsed since start.
+ *
+ * @param start start time in nanoseconds
+ * @return elapsed seconds
+ */
+static double seconds_since(unsigned long long start) {
+    return (double) (stats_now_ns() - start) / 1e9;
+}
+
+/**
+ * @brief Starts a generator process for the graph g.
+ *
+ * @param generator path to the generator executable
+ * @param g the graph, passed to the generator as arguments
+ * @return the pid of the generator
+ */
+static pid_t start_generator(const char *generator, graph *g) {
+    char **args = malloc(sizeof(char *) * (g->size_e + 2));
+    if (args == NULL) {
+        error_and_exit("error allocating memory");
+    }
+
+    args[0] = (char *) generator;
+    for (int i = 0; i < g->size_e; i++) {
+        args[i + 1] = malloc(24);
+        if (args[i + 1] == NULL) {
+            error_and_exit("error allocating memory");
+        }
+        snprintf(args[i + 1], 24, "%d-%d", g->edges[i].u, g->edges[i].v);
+    }
+    args[g->size_e + 1] = NULL;
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        error_and_exit("fork failed");
+    }
+    if (pid == 0) {
+        execv(generator, args);
+        fprintf(stderr, "%s: cannot execute %s\n", program_name, generator);
+        _exit(EXIT_FAILURE);
+    }
+
+    for (int i = 1; i <= g->size_e; i++) {
+        free(args[i]);
+    }
+    free(args);
+    return pid;
+}
+
+/**
+ * @brief Runs one benchmark, reading solutions for graph g from the given number of generators,
+ * until the budget expires or the optimum is found.
+ *
+ * @param generator path to the generator executable
+ * @param g the graph
+ * @param optimum the known optimum, or -1
+ * @param producers number of generators
+ * @param budget_ms time budget in milliseconds
+ * @param seed the seed of the random streams of the generators
+ * @return the result of the run
+ */
+static result run(const char *generator, graph *g, int optimum, int producers, int budget_ms,
+                  unsigned long long seed) {
+    result res = {.best = INT_MAX, .time_to_best = -1, .time_to_optimum = -1};
+    pid_t *pids = malloc(sizeof(pid_t) * producers);
+
+    if (pids == NULL) {
+        error_and_exit("error allocating memory");
+    }
+
+    circular_buffer *cb = circular_buffer_setup(1, NULL, seed);
+
+    unsigned long long start = stats_now_ns();
+    unsigned long long deadline = start + (unsigned long long) budget_ms * 1000000ULL;
+
+    for (int i = 0; i < producers; i++) {
+        pids[i] = start_generator(generator, g);
+    }
+
+    while (stats_now_ns() < deadline) {
+        graph fb = graph_constr();
+        if (circular_buffer_read_until(cb, &fb, NULL, deadline) == -1) {
+            graph_destr(&fb);
+            continue;
+        }
+        res.improvements++;
+        if (fb.size_e < res.best) {
+            res.best = fb.size_e;
+            res.time_to_best = seconds_since(start);
+        }
+        graph_destr(&fb);
+        if (res.best == optimum) {
+            res.time_to_optimum = res.time_to_best;
+            break;
+        }
+    }
+
+    res.elapsed = seconds_since(start);
+
+    circular_buffer_terminate(cb);
+    for (int i = 0; i < producers; i++) {
+        kill(pids[i], SIGTERM);
+    }
+    for (int i = 0; i < producers; i++) {
+        waitpid(pids[i], NULL, 0);
+    }
+
+    int attached = cb->producers < MAX_PRODUCERS ? cb->producers : MAX_PRODUCERS;
+    for (int i = 0; i < attached; i++) {
+        res.permutations += cb->stats[i].generated;
+    }
+
+    circular_buffer_destr(cb, 1);
+    free(pids);
+
+    if (res.best == INT_MAX) {
+        res.best = -1;
+    }
+    return res;
+}
+
+/**
+ * @brief The main logic of this benchmark program, running every graph family with every size
+ * and producer count, and writing the results as CSV.
+ *
+ * @param argc argument counter
+ * @param argv argument values
+ * @return EXIT_SUCCESS on successful termination, otherwise EXIT_FAILURE
+ */
+int main(int argc, char **argv) {
+    program_name = argv[0];
+    int budget_ms = 1000;
+    unsigned seed = 1;
+    const char *output_path = NULL;
+    const char *generator = "./generator";
+
+    int option_index;
+    while ((option_index = getopt(argc, argv, "t:s:o:g:")) != -1) {
+        char *endptr;
+        switch (option_index) {
+            case 't':
+                budget_ms = (int) strtol(optarg, &endptr, 10);
+                if (endptr[0] != '\0' || budget_ms <= 0) {
+                    usage();
+                }
+                break;
+            case 's':
+                seed = (unsigned) strtoul(optarg, &endptr, 10);
+                if (endptr[0] != '\0') {
+                    usage();
+                }
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'g':
+                generator = optarg;
+                break;
+            default:
+                usage();
+                break;
+        }
+    }
+
+    FILE *output = stdout;
+    if (output_path != NULL && (output = fopen(output_path, "w")) == NULL) {
+        error_and_exit("cannot open output file");
+    }
+
+    family families[] = {
+            {"planted_dag", planted_dag, {10, 20, 40}},
+            {"tournament",  tournament,  {5,  6,  7}},
+            {"power_law",   power_law,   {10, 20, 40}},
+            {"grid_cycles", grid_cycles, {9,  16, 25}},
+    };
+    int producer_counts[] = {1, 2, 4};
+
+    fprintf(output, "family,vertices,edges,producers,optimum,best,time_to_best_s,time_to_optimum_s,"
+                    "elapsed_s,improvements,improvements_per_s,permutations,permutations_per_s\n");
+
+    for (int f = 0; f < (int) (sizeof(families) / sizeof(families[0])); f++) {
+        for (int s = 0; s < 3; s++) {
+            srand(seed + f * 3 + s);
+            graph g = graph_constr();
+            int optimum = families[f].generate(&g, families[f].sizes[s]);
+
+            for (int p = 0; p < (int) (sizeof(producer_counts) / sizeof(producer_counts[0])); p++) {
+                result res = run(generator, &g, optimum, producer_counts[p], budget_ms, seed);
+                fprintf(output, "%s,%d,%d,%d,%d,%d,%.6f,%.6f,%.6f,%llu,%.1f,%llu,%.1f\n",
+                        families[f].name, g.size_v, g.size_e, producer_counts[p], optimum, res.best,
+                        res.time_to_best, res.time_to_optimum, res.elapsed, res.improvements,
+                        res.improvements / res.elapsed, res.permutations, res.permutations / res.elapsed);
+                fflush(output);
+            }
+
+            graph_destr(&g);
+        }
+    }
+
+    if (output != stdout) {
+        fclose(output);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -11,11 +11,27 @@
  */
 
 #include "circular_buffer.h"
+#include "namespace.h"
+#include "profile.h"
+#include "trace.h"
+#include "transport.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <sys/wait.h>
 #include <unistd.h>
+#include <linux/magic.h>
 
 /**
  * semaphores
@@ -29,6 +45,49 @@ sem_t *sem_mutex;
  */
 int shmfd;
 
+/**
+ * names of the shared memory and the semaphores, within the namespace passed to setup
+ */
+static char shm_name[NAME_LEN];
+static char sem_free_name[NAME_LEN];
+static char sem_used_name[NAME_LEN];
+static char sem_mutex_name[NAME_LEN];
+
+/**
+ * path of the shared memory on hugetlbfs, and whether it is used instead of the POSIX shared memory object
+ */
+static char huge_path[PATH_MAX];
+static int huge = 0;
+
+/**
+ * stats block of this generator, NULL for the server
+ */
+static producer_stats *producer = NULL;
+
+/**
+ * worker id of this generator, -1 for the server
+ */
+static int worker = -1;
+
+/**
+ * socket transport of a client: the connection to the server (-1 for the shared memory transport),
+ * the received bytes, the pending batch of solutions starting after its 10 byte header, and the
+ * counters already sent to the server
+ */
+static int sock = -1;
+static frame_buffer inbox;
+static unsigned char batch[FRAME_MAX];
+static size_t batch_len = 0;
+static int batch_count = 0;
+static unsigned long long last_poll = 0;
+static unsigned long long sent_generated = 0;
+static unsigned long long sent_dropped = 0;
+
+/**
+ * listener process of the server, serving clients using the socket transport
+ */
+static pid_t listener = -1;
+
 /**
  * @brief Prints an error message to stderr, and terminates the program
  * with EXIT_FAILURE.
@@ -41,144 +100,603 @@ static void err_exit(char *message) {
 }
 
 /**
- * @brief Sets up the circular buffer and returns the pointer to the shared memory.
+ * @brief Sets the names of the shared memory and the semaphores for the specified namespace.
  *
- * @details This function opens up the shared memory, semaphores and sets up the circular buffer.
- * Errors, which may occur during these operations, are handled by this function and will terminate
- * the program with EXIT_FAILURE and print an error message to stderr.
+ * @param ns the namespace, or NULL for the default names
+ */
+static void set_names(const char *ns) {
+    namespace_name(shm_name, ns, SHM_NAME);
+    namespace_name(sem_free_name, ns, SEM_FREE);
+    namespace_name(sem_used_name, ns, SEM_USED);
+    namespace_name(sem_mutex_name, ns, SEM_MUTEX);
+}
+
+/**
+ * @brief Opens the shared memory as a file on the hugetlbfs mount point named by FB_HUGEPAGES.
  *
- * @param server specifies, whether the caller (1) is the server or a client (0)
- * @return returns a pointer to the shared memory
+ * @param create specifies, whether the file is created (1) or has to exist (0)
+ * @param page pointer to variable, which stores the huge page size
+ * @return the file descriptor, or -1 if FB_HUGEPAGES is not set, or does not name a hugetlbfs mount point
  */
-circular_buffer *circular_buffer_setup(int server) {
+static int open_hugepages(int create, size_t *page) {
+    const char *dir = getenv(HUGEPAGES_ENV);
 
-    if (server == 1) {
-        shmfd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0600);
-    } else {
-        shmfd = shm_open(SHM_NAME, O_RDWR, 0);
+    if (dir == NULL || dir[0] == '\0') {
+        return -1;
+    }
+    if (snprintf(huge_path, sizeof(huge_path), "%s%s", dir, shm_name) >= (int) sizeof(huge_path)) {
+        return -1;
     }
 
+    int fd = open(huge_path, create ? O_CREAT | O_RDWR : O_RDWR, 0600);
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct statfs sfs;
+    if (fstatfs(fd, &sfs) == -1 || sfs.f_type != HUGETLBFS_MAGIC) {
+        close(fd);
+        if (create) {
+            unlink(huge_path);
+        }
+        errno = EINVAL;
+        return -1;
+    }
+
+    *page = (size_t) sfs.f_bsize;
+    return fd;
+}
+
+/**
+ * @brief Maps the shared memory of the server, backed by huge pages if possible.
+ *
+ * @details Falls back to a POSIX shared memory object, if FB_HUGEPAGES is not set, or if the file on
+ * hugetlbfs cannot be created or mapped, e.g. because no huge pages are reserved. A stale segment of
+ * the other kind is removed, so clients do not attach to it.
+ *
+ * @param size pointer to variable, which stores the size of the mapping
+ * @return the mapping, or MAP_FAILED on error, leaving shmfd open
+ */
+static circular_buffer *map_server(size_t *size) {
+    size_t page;
+    circular_buffer *cb = MAP_FAILED;
+
+    shmfd = open_hugepages(1, &page);
+    if (shmfd != -1) {
+        *size = (sizeof(circular_buffer) + page - 1) / page * page;
+        if (ftruncate(shmfd, *size) == 0) {
+            cb = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+        }
+        if (cb != MAP_FAILED) {
+            huge = 1;
+            shm_unlink(shm_name);
+            return cb;
+        }
+        close(shmfd);
+        unlink(huge_path);
+    }
+    if (getenv(HUGEPAGES_ENV) != NULL && getenv(HUGEPAGES_ENV)[0] != '\0') {
+        fprintf(stderr, "circular buffer: huge pages not available (%s), using %s\n", strerror(errno), shm_name);
+    }
+
+    huge = 0;
+    shmfd = shm_open(shm_name, O_CREAT | O_RDWR, 0600);
+
     if (shmfd == -1) {
         err_exit("error opening shm");
     }
 
-    if (server == 1) {
-        if (ftruncate(shmfd, sizeof(circular_buffer)) < 0) {
-            if (close(shmfd) == -1) {
-                err_exit("error closing shm fd");
-            }
-            if (shm_unlink(SHM_NAME) == -1) {
-                err_exit("error unlinking shm");
-            }
-            err_exit("error during ftruncate");
+    page = (size_t) sysconf(_SC_PAGESIZE);
+    *size = (sizeof(circular_buffer) + page - 1) / page * page;
+
+    if (ftruncate(shmfd, *size) < 0) {
+        if (close(shmfd) == -1) {
+            err_exit("error closing shm fd");
+        }
+        if (shm_unlink(shm_name) == -1) {
+            err_exit("error unlinking shm");
+        }
+        err_exit("error during ftruncate");
+    }
+
+    return mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+}
+
+/**
+ * @brief Removes the shared memory, on hugetlbfs or the POSIX shared memory object.
+ *
+ * @return 0 on success, -1 on error
+ */
+static int unlink_segment(void) {
+    return huge ? unlink(huge_path) : shm_unlink(shm_name);
+}
+
+/**
+ * @brief Sets up the circular buffer and returns the pointer to the shared memory.
+ *
+ * @details This function opens up the shared memory, semaphores and sets up the circular buffer.
+ * Errors, which may occur during these operations, are handled by this function and will terminate
+ * the program with EXIT_FAILURE and print an error message to stderr.
+ *
+ * @param server specifies, whether the caller (1) is the server or a client (0)
+ * @param ns the namespace, or NULL for the default names
+ * @param seed the seed of the random streams of the generators, ignored for a client
+ * @return returns a pointer to the shared memory
+ */
+circular_buffer *circular_buffer_setup(int server, const char *ns, unsigned long long seed) {
+
+    if (server == 0) {
+        circular_buffer *cb = circular_buffer_attach(ns);
+        if (cb == NULL) {
+            err_exit("error attaching to the circular buffer");
         }
+        return cb;
     }
 
-    circular_buffer *cb = mmap(NULL, sizeof(circular_buffer), PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+    set_names(ns);
+
+    size_t size;
+    circular_buffer *cb = map_server(&size);
 
     if (cb == MAP_FAILED) {
         if (close(shmfd) == -1) {
             err_exit("failed to close shm file descriptor");
         }
-        if (server == 1) {
-            if (shm_unlink(SHM_NAME) == -1) {
-                err_exit("error unlinking shm");
-            }
+        if (unlink_segment() == -1) {
+            err_exit("error unlinking shm");
         }
         err_exit("mapping failed");
     }
 
-    if (server == 1) {
-        sem_free = sem_open(SEM_FREE, O_CREAT | O_EXCL, 0600, MAX_DATA);
-        sem_used = sem_open(SEM_USED, O_CREAT | O_EXCL, 0600, 0);
-        sem_mutex = sem_open(SEM_MUTEX, O_CREAT | O_EXCL, 0600, 1);
-    } else {
-        sem_free = sem_open(SEM_FREE, 0);
-        sem_used = sem_open(SEM_USED, 0);
-        sem_mutex = sem_open(SEM_MUTEX, 0);
-    }
+    memset(cb, 0, size);
+    cb->magic = CIRCULAR_BUFFER_MAGIC;
+    cb->version = CIRCULAR_BUFFER_VERSION;
+    cb->size = size;
+    cb->seed = seed;
+    cb->bound = INT_MAX;
 
-    if (sem_free == SEM_FAILED) {
-        if (munmap(cb, sizeof(*cb)) == -1) {
-            err_exit("unmapping failed");
+    sem_free = sem_open(sem_free_name, O_CREAT | O_EXCL, 0600, MAX_DATA);
+    sem_used = sem_open(sem_used_name, O_CREAT | O_EXCL, 0600, 0);
+    sem_mutex = sem_open(sem_mutex_name, O_CREAT | O_EXCL, 0600, 1);
+
+    if (sem_free == SEM_FAILED || sem_used == SEM_FAILED || sem_mutex == SEM_FAILED) {
+        if (munmap(cb, size) == -1) {
+            err_exit("error unmapping shm");
         }
         if (close(shmfd) == -1) {
             err_exit("failed to close shm file descriptor");
         }
-        if (server == 1) {
-            if (shm_unlink(SHM_NAME) == -1) {
-                err_exit("error unlinking shm");
-            }
-            if (sem_unlink(SEM_FREE) == -1) {
-                err_exit("error unlinking sem_free");
-            }
+        if (unlink_segment() == -1) {
+            err_exit("error unlinking shm");
+        }
+        if (sem_free != SEM_FAILED) {
+            sem_close(sem_free);
+            sem_unlink(sem_free_name);
+        }
+        if (sem_used != SEM_FAILED) {
+            sem_close(sem_used);
+            sem_unlink(sem_used_name);
         }
-        err_exit("failed to open sem_free");
+        if (sem_mutex != SEM_FAILED) {
+            sem_close(sem_mutex);
+            sem_unlink(sem_mutex_name);
+        }
+        err_exit("failed to open semaphores");
     }
 
-    if (sem_used == SEM_FAILED) {
-        if (munmap(cb, sizeof(*cb)) == -1) {
-            err_exit("error unmapping shm");
+    return cb;
+}
+
+/**
+ * @brief Claims a free stats block for the calling generator.
+ *
+ * @details A block is free, if its generator has detached and cleared its pid, or has exited without
+ * detaching. The block is claimed by swapping its pid, so two generators never claim the same block,
+ * and its counters are reset before it is marked active again.
+ *
+ * @param cb the circular buffer
+ * @return the stats block, or NULL if all MAX_PRODUCERS blocks are taken
+ */
+static producer_stats *claim_stats(circular_buffer *cb) {
+    int self = (int) getpid();
+
+    for (int i = 0; i < MAX_PRODUCERS; i++) {
+        producer_stats *ps = &cb->stats[i];
+        int pid = __atomic_load_n(&ps->pid, __ATOMIC_ACQUIRE);
+
+        if (pid != 0 && (kill(pid, 0) == 0 || errno != ESRCH)) {
+            continue;
         }
-        if (close(shmfd) == -1) {
-            err_exit("failed to close shm file descriptor");
+        if (!__atomic_compare_exchange_n(&ps->pid, &pid, self, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            continue;
         }
-        if (server == 1) {
-            if (shm_unlink(SHM_NAME) == -1) {
-                err_exit("error unlinking shm");
-            }
+
+        __atomic_store_n(&ps->active, 0, __ATOMIC_RELAXED);
+        ps->started_ns = stats_now_ns();
+        ps->generated = 0;
+        ps->written = 0;
+        ps->dropped = 0;
+        ps->wait_free_ns = 0;
+        ps->wait_mutex_ns = 0;
+        __atomic_store_n(&ps->active, 1, __ATOMIC_RELEASE);
+        return ps;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Attaches a client to the circular buffer of a running server.
+ *
+ * @details Unlike circular_buffer_setup, errors do not terminate the program, everything opened so far
+ * is closed again and NULL is returned, e.g. if the server has already terminated or uses another layout.
+ * The shared memory is looked up on hugetlbfs first, if FB_HUGEPAGES is set.
+ *
+ * @param ns the namespace, or NULL for the default names
+ * @return returns a pointer to the shared memory, or NULL on error
+ */
+circular_buffer *circular_buffer_attach(const char *ns) {
+    set_names(ns);
+
+    size_t page;
+    shmfd = open_hugepages(0, &page);
+    huge = shmfd != -1;
+    if (shmfd == -1) {
+        shmfd = shm_open(shm_name, O_RDWR, 0);
+    }
+    if (shmfd == -1) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(shmfd, &st) == -1 || (size_t) st.st_size < sizeof(circular_buffer)) {
+        close(shmfd);
+        return NULL;
+    }
+
+    circular_buffer *cb = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+    if (cb == MAP_FAILED) {
+        close(shmfd);
+        return NULL;
+    }
+    if (cb->magic != CIRCULAR_BUFFER_MAGIC || cb->version != CIRCULAR_BUFFER_VERSION) {
+        munmap(cb, (size_t) st.st_size);
+        close(shmfd);
+        return NULL;
+    }
+
+    sem_free = sem_open(sem_free_name, 0);
+    sem_used = sem_open(sem_used_name, 0);
+    sem_mutex = sem_open(sem_mutex_name, 0);
+
+    if (sem_free == SEM_FAILED || sem_used == SEM_FAILED || sem_mutex == SEM_FAILED) {
+        if (sem_free != SEM_FAILED) {
+            sem_close(sem_free);
         }
-        if (sem_close(sem_free) == -1) {
-            err_exit("error closing sem_free");
+        if (sem_used != SEM_FAILED) {
+            sem_close(sem_used);
         }
-        if (server == 1) {
-            if (sem_unlink(SEM_FREE) == -1) {
-                err_exit("error unlinking sem_free");
-            }
-            if (sem_unlink(SEM_USED) == -1) {
-                err_exit("error unlinking sem_used");
-            }
+        if (sem_mutex != SEM_FAILED) {
+            sem_close(sem_mutex);
         }
-        err_exit("failed to open sem_used");
+        munmap(cb, cb->size);
+        close(shmfd);
+        return NULL;
     }
 
-    if (sem_mutex == SEM_FAILED) {
-        if (munmap(cb, sizeof(*cb)) == -1) {
-            err_exit("error unmapping shm");
+    worker = __atomic_fetch_add(&cb->producers, 1, __ATOMIC_RELAXED);
+    producer = claim_stats(cb);
+
+    return cb;
+}
+
+/**
+ * @brief This function saves the attachment of the buffer attached last by circular_buffer_attach.
+ *
+ * @param attachment pointer to variable, which stores the attachment
+ */
+void circular_buffer_save(buffer_attachment *attachment) {
+    attachment->sem_free = sem_free;
+    attachment->sem_used = sem_used;
+    attachment->sem_mutex = sem_mutex;
+    attachment->shmfd = shmfd;
+    attachment->producer = producer;
+    attachment->worker = worker;
+}
+
+/**
+ * @brief This function restores a saved attachment, so the following calls work on its buffer.
+ *
+ * @param attachment the attachment, saved by circular_buffer_save
+ */
+void circular_buffer_restore(const buffer_attachment *attachment) {
+    sem_free = attachment->sem_free;
+    sem_used = attachment->sem_used;
+    sem_mutex = attachment->sem_mutex;
+    shmfd = attachment->shmfd;
+    producer = attachment->producer;
+    worker = attachment->worker;
+}
+
+/**
+ * @brief Connects a client to the circular buffer of a server on another host, using the socket transport.
+ *
+ * @details The returned buffer is local to the client, only circular_buffer_write, circular_buffer_stats,
+ * circular_buffer_terminated, circular_buffer_bound, circular_buffer_seed, circular_buffer_worker and
+ * circular_buffer_destr may be used on it. The seed and the worker id are received from the server.
+ * Errors are handled like in circular_buffer_setup.
+ *
+ * @param address the address of the server, "tcp://host:port" or "unix:/path"
+ * @return returns a pointer to the local buffer
+ */
+circular_buffer *circular_buffer_connect(const char *address) {
+    sock = transport_connect(address);
+    if (sock == -1) {
+        err_exit("error connecting to the server");
+    }
+
+    circular_buffer *cb = NULL;
+    if (posix_memalign((void **) &cb, CACHE_LINE, sizeof(circular_buffer)) != 0) {
+        err_exit("error allocating memory");
+    }
+
+    memset(cb, 0, sizeof(*cb));
+    cb->magic = CIRCULAR_BUFFER_MAGIC;
+    cb->version = CIRCULAR_BUFFER_VERSION;
+    cb->size = sizeof(*cb);
+    cb->bound = INT_MAX;
+    cb->producers = 1;
+    producer = &cb->stats[0];
+    producer->pid = (int) getpid();
+    producer->started_ns = stats_now_ns();
+    producer->active = 1;
+
+    inbox.len = 0;
+    batch_len = 10;
+    batch_count = 0;
+
+    unsigned char payload[FRAME_MAX];
+    size_t len;
+    int type, r;
+    while ((r = transport_next(&inbox, &type, payload, &len)) == 0) {
+        if (transport_recv(sock, &inbox, 1) == -1) {
+            err_exit("error receiving the hello of the server");
         }
-        if (close(shmfd) == -1) {
-            err_exit("failed to close shm file descriptor");
+    }
+    if (r == -1 || type != FRAME_HELLO || len != 12) {
+        err_exit("error receiving the hello of the server");
+    }
+    cb->seed = ((unsigned long long) transport_get32(payload) << 32) | transport_get32(payload + 4);
+    worker = (int) transport_get32(payload + 8);
+
+    return cb;
+}
+
+/**
+ * @brief Sends the pending batch of solutions and the counters of this client to the server.
+ *
+ * @details Nothing is sent, if neither solutions are pending nor the counters changed.
+ * If the connection fails, the client treats the circular buffer as terminated.
+ *
+ * @param cb the local buffer of the client
+ */
+static void socket_flush(circular_buffer *cb) {
+    unsigned long long generated = producer->generated;
+    unsigned long long dropped = producer->dropped;
+
+    if (batch_count == 0 && generated == sent_generated && dropped == sent_dropped) {
+        return;
+    }
+
+    transport_put32(batch, (unsigned int) (generated - sent_generated));
+    transport_put32(batch + 4, (unsigned int) (dropped - sent_dropped));
+    batch[8] = (unsigned char) (batch_count >> 8);
+    batch[9] = (unsigned char) batch_count;
+
+    if (transport_send(sock, FRAME_SOLUTIONS, batch, batch_len) == -1) {
+        cb->terminate = 1;
+    }
+
+    sent_generated = generated;
+    sent_dropped = dropped;
+    batch_len = 10;
+    batch_count = 0;
+}
+
+/**
+ * @brief Flushes the pending solutions of this client and receives the broadcasts of the server.
+ *
+ * @param cb the local buffer of the client
+ */
+static void socket_poll(circular_buffer *cb) {
+    unsigned char payload[FRAME_MAX];
+    size_t len;
+    int type, r;
+
+    socket_flush(cb);
+
+    if (transport_recv(sock, &inbox, 0) == -1) {
+        cb->terminate = 1;
+        return;
+    }
+
+    while ((r = transport_next(&inbox, &type, payload, &len)) == 1) {
+        if (type == FRAME_BOUND && len == 4) {
+            cb->bound = (int) transport_get32(payload);
+        } else if (type == FRAME_TERMINATE) {
+            cb->terminate = 1;
         }
-        if (server == 1) {
-            if (shm_unlink(SHM_NAME) == -1) {
-                err_exit("error unlinking shm");
-            }
+    }
+    if (r == -1) {
+        cb->terminate = 1;
+    }
+}
+
+/**
+ * @brief Adds a batch of solutions, received from a client, to the circular buffer.
+ *
+ * @param cb the circular buffer, attached by the relay
+ * @param payload the payload of the frame
+ * @param len length of the payload
+ * @return 0 on success, -1 on a malformed frame
+ */
+static int relay_solutions(circular_buffer *cb, const unsigned char *payload, size_t len) {
+    if (len < 10) {
+        return -1;
+    }
+
+    stats_add(producer != NULL ? &producer->generated : NULL, transport_get32(payload));
+    stats_add(producer != NULL ? &producer->dropped : NULL, transport_get32(payload + 4));
+
+    int count = (payload[8] << 8) | payload[9];
+    size_t off = 10;
+
+    for (int i = 0; i < count; i++) {
+        if (off >= len || payload[off] > MAX_EDGES || off + 9 + 8 * payload[off] > len) {
+            return -1;
         }
-        if (sem_close(sem_free) == -1) {
-            err_exit("error closing sem_free");
+
+        graph fb = graph_constr();
+        int size = payload[off++];
+        unsigned long long iteration = ((unsigned long long) transport_get32(payload + off) << 32)
+                                       | transport_get32(payload + off + 4);
+        off += 8;
+        for (int j = 0; j < size; j++, off += 8) {
+            edge e = edge_constr((int) transport_get32(payload + off), (int) transport_get32(payload + off + 4));
+            graph_add(&fb, &e);
         }
-        if (sem_close(sem_used) == -1) {
-            err_exit("error closing sem_used");
+        circular_buffer_write(cb, &fb, iteration);
+        graph_destr(&fb);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Serves one client using the socket transport: attaches to the circular buffer like a local
+ * generator, writes the received solutions to it and sends the bound and the termination back.
+ * The client uses the seed and the worker id of the relay, which are sent first.
+ *
+ * @param client the connection to the client
+ * @param ns the namespace of the circular buffer
+ */
+static void relay(int client, const char *ns) {
+    circular_buffer *cb = circular_buffer_attach(ns);
+    if (cb == NULL) {
+        close(client);
+        return;
+    }
+
+    frame_buffer in = {.len = 0};
+    unsigned char payload[FRAME_MAX];
+    struct pollfd pfd = {.fd = client, .events = POLLIN};
+    int sent_bound = INT_MAX;
+
+    transport_put32(payload, (unsigned int) (cb->seed >> 32));
+    transport_put32(payload + 4, (unsigned int) cb->seed);
+    transport_put32(payload + 8, (unsigned int) worker);
+    int failed = transport_send(client, FRAME_HELLO, payload, 12) == -1;
+
+    while (!failed && !circular_buffer_terminated(cb)) {
+        int bound = circular_buffer_bound(cb);
+        if (bound != sent_bound) {
+            transport_put32(payload, (unsigned int) bound);
+            failed = transport_send(client, FRAME_BOUND, payload, 4) == -1;
+            sent_bound = bound;
         }
-        if (server == 1) {
-            if (sem_unlink(SEM_FREE) == -1) {
-                err_exit("error unlinking sem_free");
-            }
-            if (sem_unlink(SEM_USED) == -1) {
-                err_exit("error unlinking sem_used");
-            }
-            if (sem_unlink(SEM_MUTEX) == -1) {
-                err_exit("error unlinking sem_mutex");
+
+        if (failed || poll(&pfd, 1, SOCKET_POLL_MS) <= 0) {
+            continue;
+        }
+        if (transport_recv(client, &in, 0) == -1) {
+            break;
+        }
+
+        size_t len;
+        int type, r;
+        while ((r = transport_next(&in, &type, payload, &len)) == 1) {
+            if (type == FRAME_SOLUTIONS && relay_solutions(cb, payload, len) == -1) {
+                r = -1;
+                break;
             }
         }
-        err_exit("failed to open sem_mutex");
+        failed = r == -1;
     }
 
-    cb->rd_pos = 0;
-    cb->wr_pos = 0;
-    cb->terminate = 0;
+    if (circular_buffer_terminated(cb)) {
+        transport_send(client, FRAME_TERMINATE, NULL, 0);
+    }
+    close(client);
+    circular_buffer_destr(cb, 0);
+}
 
-    return cb;
+/**
+ * @brief Accepts clients using the socket transport and forks a relay for each of them,
+ * until the circular buffer is terminated or the server exits.
+ *
+ * @param cb the circular buffer of the server
+ * @param fd the listening socket
+ * @param address the address of the listening socket
+ * @param ns the namespace of the circular buffer
+ */
+static void listen_loop(circular_buffer *cb, int fd, const char *address, const char *ns) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    pid_t server = getppid();
+
+    while (!circular_buffer_terminated(cb) && getppid() == server) {
+        while (waitpid(-1, NULL, WNOHANG) > 0) {
+        }
+
+        if (poll(&pfd, 1, 10 * SOCKET_POLL_MS) <= 0) {
+            continue;
+        }
+        int client = accept(fd, NULL, NULL);
+        if (client == -1) {
+            continue;
+        }
+
+        if (fork() == 0) {
+            close(fd);
+            TRACE_INIT("relay");
+            relay(client, ns);
+            TRACE_FLUSH();
+            _exit(EXIT_SUCCESS);
+        }
+        close(client);
+    }
+
+    close(fd);
+    transport_unlink(address);
+    while (wait(NULL) > 0 || errno == EINTR) {
+    }
+}
+
+/**
+ * @brief Accepts clients using the socket transport on the specified address.
+ *
+ * @details Forks a listener process, which serves every connection with a relay process, until the
+ * circular buffer is terminated. Errors are handled like in circular_buffer_setup.
+ *
+ * @param cb the circular buffer of the server
+ * @param address the address to listen on, "tcp://host:port" or "unix:/path"
+ * @param ns the namespace of the circular buffer, or NULL for the default names
+ */
+void circular_buffer_listen(circular_buffer *cb, const char *address, const char *ns) {
+    int fd = transport_listen(address);
+    if (fd == -1) {
+        err_exit("error listening for generators");
+    }
+
+    listener = fork();
+    if (listener == -1) {
+        err_exit("fork failed");
+    }
+    if (listener == 0) {
+        profile_disable();
+        listen_loop(cb, fd, address, ns);
+        _exit(EXIT_SUCCESS);
+    }
+    close(fd);
 }
 
 /**
@@ -186,55 +704,274 @@ circular_buffer *circular_buffer_setup(int server) {
  *
  * @details Synchronization is ensured by the named semaphores, the caller of this function
  * has to make sure, that not more than MAX_EDGES are contained within the feedback arc graph.
+ * Nothing is written, if the server has terminated the circular buffer.
+ * The slot is staged before the semaphores are taken, so the profiled copy (PROFILE_WRITE_COPY) reads its
+ * counters outside of sem_mutex, which only guards the copy of the staged slot into the ring.
  *
  * @param cb the circular buffer
  * @param fb_g feedback arc set to be written
+ * @param iteration the iteration of the random stream of the caller, which found the feedback arc set
  */
-void circular_buffer_write(circular_buffer *cb, graph *fb_g) {
-    sem_wait(sem_free);
-    sem_wait(sem_mutex);
+void circular_buffer_write(circular_buffer *cb, graph *fb_g, unsigned long long iteration) {
+    if (sock != -1) {
+        if (cb->terminate == 0) {
+            batch[batch_len++] = (unsigned char) fb_g->size_e;
+            transport_put32(batch + batch_len, (unsigned int) (iteration >> 32));
+            transport_put32(batch + batch_len + 4, (unsigned int) iteration);
+            batch_len += 8;
+            for (int i = 0; i < fb_g->size_e; i++, batch_len += 8) {
+                transport_put32(batch + batch_len, (unsigned int) fb_g->edges[i].u);
+                transport_put32(batch + batch_len + 4, (unsigned int) fb_g->edges[i].v);
+            }
+            producer->written++;
+            if (++batch_count == SOCKET_BATCH) {
+                socket_flush(cb);
+            }
+        }
+        return;
+    }
+
+    ring_slot staged;
+    profile_begin(PROFILE_WRITE_COPY);
     for (int i = 0; i < fb_g->size_e; i++) {
-        cb->edge[cb->wr_pos][i] = fb_g->edges[i];
+        staged.edge[i] = fb_g->edges[i];
     }
-    cb->edge_s[cb->wr_pos] = fb_g->size_e;
+    profile_end(PROFILE_WRITE_COPY, (unsigned long long) fb_g->size_e);
+    staged.size = fb_g->size_e;
+    staged.worker = worker;
+    staged.iteration = iteration;
+
+    unsigned long long start = stats_now_ns();
+    sem_wait(sem_free);
+    if (__atomic_load_n(&cb->terminate, __ATOMIC_ACQUIRE) != 0) {
+        sem_post(sem_free);
+        return;
+    }
+    unsigned long long acquired = stats_now_ns();
+    sem_wait(sem_mutex);
+    unsigned long long locked = stats_now_ns();
+    memcpy(&cb->slot[cb->wr_pos], &staged, offsetof(ring_slot, edge) + sizeof(edge) * staged.size);
     cb->wr_pos += 1;
     cb->wr_pos %= MAX_DATA;
+    TRACE_BEGIN(copied);
     sem_post(sem_mutex);
     sem_post(sem_used);
+
+    if (producer != NULL) {
+        stats_add(&producer->wait_free_ns, acquired - start);
+        stats_add(&producer->wait_mutex_ns, locked - acquired);
+        stats_add(&producer->written, 1);
+    }
+    TRACE_SPAN("wait_free", start, acquired);
+    TRACE_SPAN("wait_mutex", acquired, locked);
+    TRACE_SPAN("write_copy", locked, copied);
 }
 
 /**
  * @brief This function reads the edges, of the next feedback arc set, and adds them to the graph g.
  *
+ * @details If the wait for the next feedback arc set is interrupted by a signal, nothing is read
+ * and -1 is returned, so the caller can handle the signal and try again.
+ *
+ * @param cb the circular buffer
+ * @param g the graph, where edges from the buffer are added to
+ * @param origin pointer to variable, which stores the origin of the feedback arc set, or NULL
+ * @return 0 on success, -1 if interrupted by a signal
+ */
+int circular_buffer_read(circular_buffer *cb, graph *g, solution_origin *origin) {
+    return circular_buffer_read_until(cb, g, origin, 0);
+}
+
+/**
+ * @brief This function reads the next feedback arc set like circular_buffer_read, waiting at most
+ * until deadline_ns.
+ *
+ * @details The wait is bounded by sem_timedwait, so a deadline passing right before the wait cannot be
+ * missed like a timer signal could. Since sem_timedwait measures CLOCK_REALTIME, the remaining time is
+ * converted at the start of the wait.
+ *
  * @param cb the circular buffer
  * @param g the graph, where edges from the buffer are added to
+ * @param origin pointer to variable, which stores the origin of the feedback arc set, or NULL
+ * @param deadline_ns the deadline in stats_now_ns time, or 0 to wait without a deadline
+ * @return 0 on success, -1 if interrupted by a signal or the deadline has passed (errno is ETIMEDOUT then)
  */
-void circular_buffer_read(circular_buffer *cb, graph *g) {
-    sem_wait(sem_used);
-    for (int i = 0; i < cb->edge_s[cb->rd_pos]; i++) {
-        graph_add(g, &cb->edge[cb->rd_pos][i]);
+int circular_buffer_read_until(circular_buffer *cb, graph *g, solution_origin *origin, unsigned long long deadline_ns) {
+    TRACE_BEGIN(wait_span);
+    if (deadline_ns == 0) {
+        if (sem_wait(sem_used) == -1) {
+            return -1;
+        }
+    } else {
+        unsigned long long now = stats_now_ns();
+        unsigned long long remaining = deadline_ns > now ? deadline_ns - now : 0;
+        struct timespec abs;
+        clock_gettime(CLOCK_REALTIME, &abs);
+        remaining += (unsigned long long) abs.tv_nsec;
+        abs.tv_sec += (time_t) (remaining / 1000000000ULL);
+        abs.tv_nsec = (long) (remaining % 1000000000ULL);
+        if (sem_timedwait(sem_used, &abs) == -1) {
+            return -1;
+        }
+    }
+    TRACE_END(wait_span, "wait_used");
+    TRACE_BEGIN(copy);
+    ring_slot *slot = &cb->slot[cb->rd_pos];
+    profile_begin(PROFILE_READ_COPY);
+    for (int i = 0; i < slot->size; i++) {
+        graph_add(g, &slot->edge[i]);
+    }
+    profile_end(PROFILE_READ_COPY, (unsigned long long) slot->size);
+    TRACE_END(copy, "read_copy");
+    if (origin != NULL) {
+        origin->worker = slot->worker;
+        origin->iteration = slot->iteration;
     }
     cb->rd_pos += 1;
     cb->rd_pos %= MAX_DATA;
     sem_post(sem_free);
+
+    return 0;
+}
+
+/**
+ * @brief This function returns the number of feedback arc sets waiting to be read.
+ *
+ * @param cb the circular buffer
+ * @return number of filled slots
+ */
+int circular_buffer_fill(circular_buffer *cb) {
+    int fill = 0;
+    if (sem_getvalue(sem_used, &fill) == -1 || fill < 0) {
+        return 0;
+    }
+    return fill;
+}
+
+/**
+ * @brief This function returns the stats block of the calling generator.
+ *
+ * @param cb the circular buffer
+ * @return the stats block, or NULL if the caller is the server or all blocks are taken
+ */
+producer_stats *circular_buffer_stats(circular_buffer *cb) {
+    return producer;
+}
+
+/**
+ * @brief This function checks, whether the server has terminated the circular buffer.
+ *
+ * @details Clients using the socket transport also flush their pending solutions and receive
+ * the broadcasts of the server, at most every SOCKET_POLL_MS milliseconds.
+ *
+ * @param cb the circular buffer
+ * @return 1 if the circular buffer was terminated, 0 otherwise
+ */
+int circular_buffer_terminated(circular_buffer *cb) {
+    if (sock != -1) {
+        unsigned long long now = stats_now_ns();
+        if (cb->terminate == 0 && now - last_poll >= SOCKET_POLL_MS * 1000000ULL) {
+            last_poll = now;
+            socket_poll(cb);
+        }
+        return cb->terminate;
+    }
+    return __atomic_load_n(&cb->terminate, __ATOMIC_ACQUIRE) != 0;
+}
+
+/**
+ * @brief This function returns the seed of the random streams of the generators.
+ *
+ * @param cb the circular buffer
+ * @return the seed
+ */
+unsigned long long circular_buffer_seed(circular_buffer *cb) {
+    return cb->seed;
+}
+
+/**
+ * @brief This function returns the worker id of the calling generator.
+ *
+ * @param cb the circular buffer
+ * @return the worker id, or -1 if the caller is the server
+ */
+int circular_buffer_worker(circular_buffer *cb) {
+    return worker;
+}
+
+/**
+ * @brief This function returns the size of the best solution known to the server.
+ *
+ * @param cb the circular buffer
+ * @return the bound, INT_MAX if the server has no solution yet
+ */
+int circular_buffer_bound(circular_buffer *cb) {
+    return __atomic_load_n(&cb->bound, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief This function publishes the size of the best solution known to the server.
+ *
+ * @param cb the circular buffer
+ * @param bound the bound, INT_MAX if there is no solution
+ */
+void circular_buffer_set_bound(circular_buffer *cb, int bound) {
+    __atomic_store_n(&cb->bound, bound, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief This function tells all clients to terminate.
+ *
+ * @details Sets the terminate flag and posts sem_free, so a client blocked in circular_buffer_write
+ * wakes up. Every woken client posts sem_free again, so all blocked clients wake up one after another.
+ *
+ * @param cb the circular buffer
+ */
+void circular_buffer_terminate(circular_buffer *cb) {
+    __atomic_store_n(&cb->terminate, 1, __ATOMIC_RELEASE);
+    sem_post(sem_free);
 }
 
 /**
  * @brief This function destructs the circular buffer, closing and unlinking the shared memory and semaphores.
  *
  * @details Errors, which may occur during these operations, are handled by this function and will terminate
- * the program with EXIT_FAILURE and print an error message to stderr.
+ * the program with EXIT_FAILURE and print an error message to stderr. A client marks its stats block
+ * inactive and frees it for the next generator. Its series, labeled with its pid, end there, since the
+ * metrics (see stats_write) only export active blocks.
  *
  * @param cb the circular buffer
  * @param server specifies, whether the caller (1) is the server or a client (0)
  */
 void circular_buffer_destr(circular_buffer *cb, int server) {
-    munmap(cb, sizeof(*cb));
+    if (sock != -1) {
+        socket_flush(cb);
+        close(sock);
+        sock = -1;
+        producer = NULL;
+        worker = -1;
+        free(cb);
+        return;
+    }
+
+    if (server == 1 && listener > 0) {
+        waitpid(listener, NULL, 0);
+        listener = -1;
+    }
+
+    if (producer != NULL) {
+        __atomic_store_n(&producer->active, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&producer->pid, 0, __ATOMIC_RELEASE);
+        producer = NULL;
+    }
+    worker = -1;
+
+    munmap(cb, cb->size);
 
     close(shmfd);
 
     if (server == 1) {
-        shm_unlink(SHM_NAME);
+        unlink_segment();
     }
 
     sem_close(sem_free);
@@ -242,8 +979,8 @@ void circular_buffer_destr(circular_buffer *cb, int server) {
     sem_close(sem_mutex);
 
     if (server == 1) {
-        sem_unlink(SEM_FREE);
-        sem_unlink(SEM_USED);
-        sem_unlink(SEM_MUTEX);
+        sem_unlink(sem_free_name);
+        sem_unlink(sem_used_name);
+        sem_unlink(sem_mutex_name);
     }
 }
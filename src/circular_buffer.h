@@ -8,6 +8,11 @@
  * @details These functions are used to set up the circular buffer using shared memory and named semaphores.
  * Data, edges of a graph, are written to this buffer by a generator program.
  * This written data is then read by a supervisor program.
+ *
+ * Generators on other hosts use the socket transport instead (see transport.h): circular_buffer_connect
+ * returns a buffer local to the generator, whose writes are sent in batches to the supervisor. There, every
+ * connection is served by a relay process, which attaches to the shared memory like a local generator and
+ * sends the bound and the termination back.
  */
 
 #ifndef CIRCULAR_BUFFER_H
@@ -15,34 +20,104 @@
 
 #include <semaphore.h>
 #include "graph_util.h"
+#include "stats.h"
 
 /**
  * shared memory name and its max capacity
  * maximum 60 sets with a maximum of 8 edges
  */
-#define SHM_NAME "/11806442_shm"
+#define SHM_NAME "shm"
 #define MAX_DATA (60)
 #define MAX_EDGES (8)
 
 /**
  * named semaphores to synchronize reading and mutually exclusive writing.
+ * All names are prefixed and namespaced as described in namespace.h, e.g. /11806442_shm
+ */
+#define SEM_FREE "sem_free"
+#define SEM_USED "sem_used"
+#define SEM_MUTEX "sem_mutex"
+
+/**
+ * socket transport: maximum number of solutions sent in one frame, and the interval in milliseconds,
+ * in which a generator flushes its solutions and receives broadcasts, or a relay checks the buffer
+ */
+#define SOCKET_BATCH (16)
+#define SOCKET_POLL_MS (2)
+
+
+/**
+ * magic number and version of the shared memory layout, clients refuse to attach to another layout
+ */
+#define CIRCULAR_BUFFER_MAGIC (0x46425242)
+#define CIRCULAR_BUFFER_VERSION (3)
+
+/**
+ * environment variable naming a hugetlbfs mount point, e.g. /dev/hugepages. If set, the shared memory
+ * is a file there and backed by huge pages, otherwise or if that fails, it is a POSIX shared memory object.
+ */
+#define HUGEPAGES_ENV "FB_HUGEPAGES"
+
+/**
+ * a slot of the circular buffer, holding one feedback arc set of size edges, aligned to cache lines,
+ * so the server reading a slot does not false share with a generator writing the next one.
+ * worker and iteration tell, which draw of the random streams (see rng.h) found the feedback arc set.
  */
-#define SEM_FREE "/11806442_sem_free"
-#define SEM_USED "/11806442_sem_used"
-#define SEM_MUTEX "/11806442_sem_mutex"
+typedef struct ring_slot {
+    int size;
+    int worker;
+    unsigned long long iteration;
+    edge edge[MAX_EDGES];
+} CACHE_ALIGNED ring_slot;
 
+/**
+ * @brief the origin of a feedback arc set read from the circular buffer.
+ */
+typedef struct solution_origin {
+    int worker;
+    unsigned long long iteration;
+} solution_origin;
 
 /**
- * struct implementing the circular buffer, memory size is 4092 bytes
+ * struct implementing the circular buffer.
+ * Every control word is alone on its cache line: terminate and bound are written by the server and read
+ * by every generator on each solution, wr_pos is only written by the generators and rd_pos only by the server.
+ * producers counts the generators, which attached to the buffer. An attached generator owns a free stats block,
+ * if there is one, and frees it again when it detaches, so at most MAX_PRODUCERS generators at a time have stats.
+ * bound is the size of the best solution known to the server, only smaller solutions are worth writing.
+ * size is the size of the mapping, a multiple of the page size.
+ * seed is the seed of the random streams of all generators, every generator uses the number of generators
+ * attached before it as its worker id, which is unique even beyond MAX_PRODUCERS.
  */
 typedef struct circular_buffer {
-    int terminate;
-    int wr_pos;
-    int rd_pos;
-    int edge_s[MAX_DATA];
-    edge edge[MAX_DATA][MAX_EDGES];
+    int magic;
+    int version;
+    int producers;
+    size_t size;
+    unsigned long long seed;
+    CACHE_ALIGNED int terminate;
+    CACHE_ALIGNED int bound;
+    CACHE_ALIGNED int wr_pos;
+    CACHE_ALIGNED int rd_pos;
+    ring_slot slot[MAX_DATA];
+    CACHE_ALIGNED producer_stats stats[MAX_PRODUCERS];
 } circular_buffer;
 
+/**
+ * @brief the state of this process, belonging to a circular buffer attached by circular_buffer_attach:
+ * the semaphores, the shared memory file descriptor, the stats block and the worker id.
+ * The functions of this module work on the buffer attached last, a client attached to several buffers
+ * saves each attachment and restores it, before using that buffer again.
+ */
+typedef struct buffer_attachment {
+    sem_t *sem_free;
+    sem_t *sem_used;
+    sem_t *sem_mutex;
+    int shmfd;
+    producer_stats *producer;
+    int worker;
+} buffer_attachment;
+
 /**
  * @brief Sets up the circular buffer and returns the pointer to the shared memory.
  *
@@ -51,34 +126,183 @@ typedef struct circular_buffer {
  * the program with EXIT_FAILURE and print an error message to stderr.
  *
  * @param server specifies, whether the caller (1) is the server or a client (0)
+ * @param ns the namespace, or NULL for the default names
+ * @param seed the seed of the random streams of the generators, ignored for a client
  * @return returns a pointer to the shared memory
  */
-circular_buffer *circular_buffer_setup(int server);
+circular_buffer *circular_buffer_setup(int server, const char *ns, unsigned long long seed);
+
+/**
+ * @brief Attaches a client to the circular buffer of a running server.
+ *
+ * @details Unlike circular_buffer_setup, errors do not terminate the program, everything opened so far
+ * is closed again and NULL is returned, e.g. if the server has already terminated.
+ *
+ * @param ns the namespace, or NULL for the default names
+ * @return returns a pointer to the shared memory, or NULL on error
+ */
+circular_buffer *circular_buffer_attach(const char *ns);
+
+/**
+ * @brief This function saves the attachment of the buffer attached last by circular_buffer_attach.
+ *
+ * @param attachment pointer to variable, which stores the attachment
+ */
+void circular_buffer_save(buffer_attachment *attachment);
+
+/**
+ * @brief This function restores a saved attachment, so the following calls work on its buffer.
+ *
+ * @param attachment the attachment, saved by circular_buffer_save
+ */
+void circular_buffer_restore(const buffer_attachment *attachment);
+
+/**
+ * @brief Connects a client to the circular buffer of a server on another host, using the socket transport.
+ *
+ * @details The returned buffer is local to the client, only circular_buffer_write, circular_buffer_stats,
+ * circular_buffer_terminated, circular_buffer_bound, circular_buffer_seed, circular_buffer_worker and
+ * circular_buffer_destr may be used on it. The seed and the worker id are received from the server.
+ * Errors are handled like in circular_buffer_setup.
+ *
+ * @param address the address of the server, "tcp://host:port" or "unix:/path"
+ * @return returns a pointer to the local buffer
+ */
+circular_buffer *circular_buffer_connect(const char *address);
+
+/**
+ * @brief Accepts clients using the socket transport on the specified address.
+ *
+ * @details Forks a listener process, which serves every connection with a relay process, until the
+ * circular buffer is terminated. Errors are handled like in circular_buffer_setup.
+ *
+ * @param cb the circular buffer of the server
+ * @param address the address to listen on, "tcp://host:port" or "unix:/path"
+ * @param ns the namespace of the circular buffer, or NULL for the default names
+ */
+void circular_buffer_listen(circular_buffer *cb, const char *address, const char *ns);
 
 /**
  * @brief This function writes a feedback arc set to the shared memory circular buffer.
  *
  * @details Synchronization is ensured by the named semaphores, the caller of this function
  * has to make sure, that not more than MAX_EDGES are contained within the feedback arc graph.
+ * Nothing is written, if the server has terminated the circular buffer.
+ * The slot is staged before the semaphores are taken, so the profiled copy (PROFILE_WRITE_COPY) reads its
+ * counters outside of sem_mutex, which only guards the copy of the staged slot into the ring.
  *
  * @param cb the circular buffer
  * @param fb_g feedback arc set to be written
+ * @param iteration the iteration of the random stream of the caller, which found the feedback arc set
  */
-void circular_buffer_write(circular_buffer *cb, graph *fb_g);
+void circular_buffer_write(circular_buffer *cb, graph *fb_g, unsigned long long iteration);
 
 /**
  * @brief This function reads the edges, of the next feedback arc set, and adds them to the graph g.
  *
+ * @details If the wait for the next feedback arc set is interrupted by a signal, nothing is read
+ * and -1 is returned, so the caller can handle the signal and try again.
+ *
  * @param cb the circular buffer
  * @param g the graph, where edges from the buffer are added to
+ * @param origin pointer to variable, which stores the origin of the feedback arc set, or NULL
+ * @return 0 on success, -1 if interrupted by a signal
  */
-void circular_buffer_read(circular_buffer *cb, graph *g);
+int circular_buffer_read(circular_buffer *cb, graph *g, solution_origin *origin);
+
+/**
+ * @brief This function reads the next feedback arc set like circular_buffer_read, waiting at most
+ * until deadline_ns.
+ *
+ * @details The wait is bounded by sem_timedwait, so a deadline passing right before the wait cannot be
+ * missed like a timer signal could. Since sem_timedwait measures CLOCK_REALTIME, the remaining time is
+ * converted at the start of the wait.
+ *
+ * @param cb the circular buffer
+ * @param g the graph, where edges from the buffer are added to
+ * @param origin pointer to variable, which stores the origin of the feedback arc set, or NULL
+ * @param deadline_ns the deadline in stats_now_ns time, or 0 to wait without a deadline
+ * @return 0 on success, -1 if interrupted by a signal or the deadline has passed (errno is ETIMEDOUT then)
+ */
+int circular_buffer_read_until(circular_buffer *cb, graph *g, solution_origin *origin, unsigned long long deadline_ns);
+
+/**
+ * @brief This function returns the number of feedback arc sets waiting to be read.
+ *
+ * @param cb the circular buffer
+ * @return number of filled slots
+ */
+int circular_buffer_fill(circular_buffer *cb);
+
+/**
+ * @brief This function returns the stats block of the calling generator.
+ *
+ * @param cb the circular buffer
+ * @return the stats block, or NULL if the caller is the server or all blocks are taken
+ */
+producer_stats *circular_buffer_stats(circular_buffer *cb);
+
+/**
+ * @brief This function checks, whether the server has terminated the circular buffer.
+ *
+ * @details Clients using the socket transport also flush their pending solutions and receive
+ * the broadcasts of the server, at most every SOCKET_POLL_MS milliseconds.
+ *
+ * @param cb the circular buffer
+ * @return 1 if the circular buffer was terminated, 0 otherwise
+ */
+int circular_buffer_terminated(circular_buffer *cb);
+
+/**
+ * @brief This function returns the seed of the random streams of the generators.
+ *
+ * @param cb the circular buffer
+ * @return the seed
+ */
+unsigned long long circular_buffer_seed(circular_buffer *cb);
+
+/**
+ * @brief This function returns the worker id of the calling generator.
+ *
+ * @param cb the circular buffer
+ * @return the worker id, or -1 if the caller is the server
+ */
+int circular_buffer_worker(circular_buffer *cb);
+
+/**
+ * @brief This function returns the size of the best solution known to the server.
+ *
+ * @param cb the circular buffer
+ * @return the bound, INT_MAX if the server has no solution yet
+ */
+int circular_buffer_bound(circular_buffer *cb);
+
+/**
+ * @brief This function publishes the size of the best solution known to the server.
+ *
+ * @param cb the circular buffer
+ * @param bound the bound, INT_MAX if there is no solution
+ */
+void circular_buffer_set_bound(circular_buffer *cb, int bound);
+
+/**
+ * @brief This function tells all clients to terminate.
+ *
+ * @details Sets the terminate flag and posts sem_free, so a client blocked in circular_buffer_write
+ * wakes up. Every woken client posts sem_free again, so all blocked clients wake up one after another.
+ *
+ * @param cb the circular buffer
+ */
+void circular_buffer_terminate(circular_buffer *cb);
 
 /**
  * @brief This function destructs the circular buffer, closing and unlinking the shared memory and semaphores.
  *
  * @details Errors, which may occur during these operations, are handled by this function and will terminate
- * the program with EXIT_FAILURE and print an error message to stderr.
+ * the program with EXIT_FAILURE and print an error message to stderr. A client using the socket transport
+ * sends its pending solutions and closes the connection, a server waits for its listener to exit.
+ * A client marks its stats block inactive and frees it for the next generator. Its series, labeled with its
+ * pid, end there, since the metrics (see stats_write) only export active blocks.
  *
  * @param cb the circular buffer
  * @param server specifies, whether the caller (1) is the server or a client (0)
@@ -0,0 +1,368 @@
+/**
+ * @file elite_pool.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The shared pool of elite vertex orders, for the recombination of orders across generators.
+ */
+
+#include "elite_pool.h"
+#include "namespace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <semaphore.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * semaphore guarding the pool, and the shared memory file descriptor
+ */
+static sem_t *sem_pool = SEM_FAILED;
+static int pool_fd = -1;
+
+/**
+ * names of the shared memory and the semaphore, within the namespace passed to setup or attach
+ */
+static char pool_name[NAME_LEN];
+static char sem_pool_name[NAME_LEN];
+
+/**
+ * @brief Prints an error message to stderr, and terminates the program
+ * with EXIT_FAILURE.
+ *
+ * @param message to be printed
+ */
+static void err_exit(char *message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Locks the pool, retrying if interrupted by a signal.
+ */
+static void pool_lock(void) {
+    while (sem_wait(sem_pool) == -1 && errno == EINTR) {
+    }
+}
+
+/**
+ * @brief Unlocks the pool.
+ */
+static void pool_unlock(void) {
+    sem_post(sem_pool);
+}
+
+/**
+ * @brief Counts the positions, in which two vertex orders differ.
+ *
+ * @param a the first order
+ * @param b the second order
+ * @param n the number of vertices
+ * @return the number of differing positions
+ */
+static int distance(const int *a, const int *b, int n) {
+    int d = 0;
+    for (int i = 0; i < n; i++) {
+        d += a[i] != b[i];
+    }
+    return d;
+}
+
+/**
+ * @brief Sets up the pool and returns the pointer to the shared memory.
+ *
+ * @details Errors, which may occur during these operations, are handled by this function and will terminate
+ * the program with EXIT_FAILURE and print an error message to stderr.
+ *
+ * @param ns the namespace, or NULL for the default names
+ * @return returns a pointer to the shared memory
+ */
+elite_pool *elite_pool_setup(const char *ns) {
+    namespace_name(pool_name, ns, POOL_NAME);
+    namespace_name(sem_pool_name, ns, SEM_POOL);
+
+    pool_fd = shm_open(pool_name, O_CREAT | O_RDWR, 0600);
+    if (pool_fd == -1) {
+        err_exit("error opening pool shm");
+    }
+
+    if (ftruncate(pool_fd, sizeof(elite_pool)) < 0) {
+        close(pool_fd);
+        shm_unlink(pool_name);
+        err_exit("error during ftruncate of pool");
+    }
+
+    elite_pool *p = mmap(NULL, sizeof(elite_pool), PROT_READ | PROT_WRITE, MAP_SHARED, pool_fd, 0);
+    if (p == MAP_FAILED) {
+        close(pool_fd);
+        shm_unlink(pool_name);
+        err_exit("mapping of pool failed");
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->magic = POOL_MAGIC;
+    p->version = POOL_VERSION;
+    p->worst = INT_MAX;
+
+    sem_pool = sem_open(sem_pool_name, O_CREAT | O_EXCL, 0600, 1);
+    if (sem_pool == SEM_FAILED) {
+        munmap(p, sizeof(*p));
+        close(pool_fd);
+        shm_unlink(pool_name);
+        err_exit("failed to open pool semaphore");
+    }
+
+    return p;
+}
+
+/**
+ * @brief Attaches a generator to the pool of a running supervisor.
+ *
+ * @details A pool, whose size does not match yet, e.g. since the supervisor has not truncated it so far,
+ * is not mapped, so accessing it cannot raise SIGBUS.
+ *
+ * @param ns the namespace, or NULL for the default names
+ * @return returns a pointer to the shared memory, or NULL on error
+ */
+elite_pool *elite_pool_attach(const char *ns) {
+    namespace_name(pool_name, ns, POOL_NAME);
+    namespace_name(sem_pool_name, ns, SEM_POOL);
+
+    pool_fd = shm_open(pool_name, O_RDWR, 0);
+    if (pool_fd == -1) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(pool_fd, &st) == -1 || (size_t) st.st_size != sizeof(elite_pool)) {
+        close(pool_fd);
+        return NULL;
+    }
+
+    elite_pool *p = mmap(NULL, sizeof(elite_pool), PROT_READ | PROT_WRITE, MAP_SHARED, pool_fd, 0);
+    if (p == MAP_FAILED) {
+        close(pool_fd);
+        return NULL;
+    }
+
+    sem_pool = sem_open(sem_pool_name, 0);
+    if (sem_pool == SEM_FAILED || p->magic != POOL_MAGIC || p->version != POOL_VERSION) {
+        if (sem_pool != SEM_FAILED) {
+            sem_close(sem_pool);
+            sem_pool = SEM_FAILED;
+        }
+        munmap(p, sizeof(*p));
+        close(pool_fd);
+        return NULL;
+    }
+
+    return p;
+}
+
+/**
+ * @brief This function saves the attachment of the pool attached last by elite_pool_attach.
+ *
+ * @param attachment pointer to variable, which stores the attachment
+ */
+void elite_pool_save(pool_attachment *attachment) {
+    attachment->sem_pool = sem_pool;
+    attachment->pool_fd = pool_fd;
+}
+
+/**
+ * @brief This function restores a saved attachment, so the following calls work on its pool.
+ *
+ * @param attachment the attachment, saved by elite_pool_save
+ */
+void elite_pool_restore(const pool_attachment *attachment) {
+    sem_pool = attachment->sem_pool;
+    pool_fd = attachment->pool_fd;
+}
+
+/**
+ * @brief This function computes the key identifying a graph in the pool.
+ *
+ * @details FNV-1a over the number of vertices and the edges in dense ids, so generators building the same
+ * kernel from their arguments share the pool with generators attached to the published graph.
+ *
+ * @param gs the graph
+ * @return the key, never 0
+ */
+unsigned long long elite_pool_key(const graph_shm *gs) {
+    const edge *edges = graph_shm_edges(gs);
+    unsigned long long h = 0xCBF29CE484222325ULL;
+
+    h = (h ^ (unsigned int) gs->size_v) * 0x100000001B3ULL;
+    for (int k = 0; k < gs->size_e; k++) {
+        h = (h ^ (unsigned int) edges[k].u) * 0x100000001B3ULL;
+        h = (h ^ (unsigned int) edges[k].v) * 0x100000001B3ULL;
+    }
+    return h != 0 ? h : 1;
+}
+
+/**
+ * @brief This function offers a vertex order to the pool.
+ *
+ * @details Orders of graphs with more than POOL_MAX_VERTICES vertices are never accepted, and counted
+ * as oversized.
+ *
+ * @param p the pool
+ * @param gs the graph of the order
+ * @param key the key of gs
+ * @param order the vertex order
+ * @param fitness the number of backward edges of order
+ * @param worker the worker id of the caller
+ * @return 1 if the order was accepted, 0 otherwise
+ */
+int elite_pool_offer(elite_pool *p, const graph_shm *gs, unsigned long long key, const int *order, int fitness,
+                     int worker) {
+    if (gs->size_v > POOL_MAX_VERTICES) {
+        __atomic_fetch_add(&p->oversized, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    __atomic_fetch_add(&p->offered, 1, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&p->key, __ATOMIC_RELAXED) == key
+        && fitness >= __atomic_load_n(&p->worst, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+
+    pool_lock();
+
+    if (p->key != key) {
+        if (p->count > 0 && gs->generation <= p->generation) {
+            pool_unlock();
+            return 0;
+        }
+        p->key = key;
+        p->generation = gs->generation;
+        p->size_v = gs->size_v;
+        p->count = 0;
+    }
+
+    int min_distance = gs->size_v / POOL_DIVERSITY > 0 ? gs->size_v / POOL_DIVERSITY : 1;
+    int nearest = -1;
+    int nearest_distance = INT_MAX;
+    int worst = -1;
+
+    for (int i = 0; i < p->count; i++) {
+        int d = distance(order, p->elites[i].order, gs->size_v);
+        if (d < nearest_distance) {
+            nearest = i;
+            nearest_distance = d;
+        }
+        if (worst == -1 || p->elites[i].fitness > p->elites[worst].fitness) {
+            worst = i;
+        }
+    }
+
+    int slot = -1;
+    if (nearest != -1 && nearest_distance < min_distance) {
+        slot = fitness < p->elites[nearest].fitness ? nearest : -1;
+    } else if (p->count < POOL_SIZE) {
+        slot = p->count++;
+    } else if (fitness < p->elites[worst].fitness) {
+        slot = worst;
+    }
+
+    if (slot != -1) {
+        p->elites[slot].fitness = fitness;
+        p->elites[slot].worker = worker;
+        memcpy(p->elites[slot].order, order, sizeof(int) * gs->size_v);
+        p->accepted++;
+    }
+
+    int max = INT_MAX;
+    if (p->count == POOL_SIZE) {
+        max = p->elites[0].fitness;
+        for (int i = 1; i < p->count; i++) {
+            max = p->elites[i].fitness > max ? p->elites[i].fitness : max;
+        }
+    }
+    __atomic_store_n(&p->worst, max, __ATOMIC_RELAXED);
+
+    pool_unlock();
+    return slot != -1;
+}
+
+/**
+ * @brief This function copies two different elites of the pool, drawn at random.
+ *
+ * @param p the pool
+ * @param gs the graph
+ * @param key the key of gs
+ * @param rng the random stream of the caller
+ * @param a buffer of size_v integers, receiving the first elite
+ * @param b buffer of size_v integers, receiving the second elite
+ * @return 0 on success, -1 if the pool holds less than two elites of gs
+ */
+int elite_pool_pick(elite_pool *p, const graph_shm *gs, unsigned long long key, rng_stream *rng, int *a, int *b) {
+    if (__atomic_load_n(&p->key, __ATOMIC_RELAXED) != key || __atomic_load_n(&p->count, __ATOMIC_RELAXED) < 2) {
+        return -1;
+    }
+
+    pool_lock();
+
+    if (p->key != key || p->count < 2) {
+        pool_unlock();
+        return -1;
+    }
+
+    int i = rng_below(rng, p->count);
+    int j = rng_below(rng, p->count - 1);
+    j += j >= i;
+
+    memcpy(a, p->elites[i].order, sizeof(int) * gs->size_v);
+    memcpy(b, p->elites[j].order, sizeof(int) * gs->size_v);
+
+    pool_unlock();
+    return 0;
+}
+
+/**
+ * @brief This function fills the pool fields of a stats snapshot.
+ *
+ * @details Reads the pool without the semaphore, so the snapshot may mix two offers.
+ *
+ * @param p the pool
+ * @param rs the snapshot
+ */
+void elite_pool_stats(elite_pool *p, ring_stats *rs) {
+    int count = __atomic_load_n(&p->count, __ATOMIC_RELAXED);
+    int best = INT_MAX;
+
+    for (int i = 0; i < count && i < POOL_SIZE; i++) {
+        int fitness = __atomic_load_n(&p->elites[i].fitness, __ATOMIC_RELAXED);
+        best = fitness < best ? fitness : best;
+    }
+
+    rs->pool_elites = count;
+    rs->pool_best = best == INT_MAX ? -1 : best;
+    rs->pool_offered = __atomic_load_n(&p->offered, __ATOMIC_RELAXED);
+    rs->pool_accepted = __atomic_load_n(&p->accepted, __ATOMIC_RELAXED);
+    rs->pool_oversized = __atomic_load_n(&p->oversized, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief This function detaches from the pool, the supervisor also removes it.
+ *
+ * @param p the pool
+ * @param server specifies, whether the caller (1) is the supervisor or a generator (0)
+ */
+void elite_pool_destr(elite_pool *p, int server) {
+    munmap(p, sizeof(*p));
+    close(pool_fd);
+    pool_fd = -1;
+    sem_close(sem_pool);
+    sem_pool = SEM_FAILED;
+
+    if (server == 1) {
+        shm_unlink(pool_name);
+        sem_unlink(sem_pool_name);
+    }
+}
@@ -0,0 +1,175 @@
+/**
+ * @file elite_pool.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the shared pool of elite vertex orders, implemented by @file elite_pool.c
+ *
+ * @details The circular buffer only carries feedback arc sets, the vertex orders, which produced them, stay
+ * within the generators. The supervisor therefore sets up a small pool of the best orders in shared memory,
+ * which generators in recombination mode offer their improvements to, and draw two elites from, to produce
+ * offspring by crossover and mutation (see solver.h). Access is mutually exclusive by a named semaphore.
+ *
+ * An order is only accepted, if it differs from every elite in at least size_v / POOL_DIVERSITY positions,
+ * otherwise it can only replace the nearest elite, if it is better. So the pool does not collapse onto
+ * copies of a single order. The pool belongs to one graph, identified by a key over its edges: offers for
+ * another graph are rejected, unless the pool is empty or the graph is a newer generation, which resets it.
+ */
+
+#ifndef FB_ARC_SET_ELITE_POOL_H
+#define FB_ARC_SET_ELITE_POOL_H
+
+#include <semaphore.h>
+#include "graph_shm.h"
+#include "rng.h"
+#include "stats.h"
+
+/**
+ * shared memory and semaphore name of the pool (see namespace.h), its magic number and layout version
+ */
+#define POOL_NAME "pool"
+#define SEM_POOL "sem_pool"
+#define POOL_MAGIC (0x46424550)
+#define POOL_VERSION (2)
+
+/**
+ * number of elites, maximum number of vertices of a graph, whose orders are pooled,
+ * and the fraction of the positions, in which an accepted order differs from every elite
+ */
+#define POOL_SIZE (8)
+#define POOL_MAX_VERTICES (4096)
+#define POOL_DIVERSITY (8)
+
+/**
+ * @brief an elite vertex order, fitness is its number of backward edges, worker the generator offering it.
+ */
+typedef struct elite {
+    int fitness;
+    int worker;
+    int order[POOL_MAX_VERTICES];
+} elite;
+
+/**
+ * @brief the shared pool.
+ * key and generation identify the graph, whose orders are pooled, key 0 if the pool belongs to no graph.
+ * count and worst, the fitness of the worst elite of a full pool or INT_MAX, are read without the semaphore,
+ * so generators skip hopeless offers without locking. offered and accepted count the offers, oversized
+ * the orders, which were not offered, since the graph has more than POOL_MAX_VERTICES vertices.
+ */
+typedef struct elite_pool {
+    int magic;
+    int version;
+    unsigned long long key;
+    int generation;
+    int size_v;
+    CACHE_ALIGNED int count;
+    int worst;
+    unsigned long long offered;
+    unsigned long long accepted;
+    unsigned long long oversized;
+    CACHE_ALIGNED elite elites[POOL_SIZE];
+} elite_pool;
+
+/**
+ * @brief the state of this process, belonging to a pool attached by elite_pool_attach: the semaphore and
+ * the shared memory file descriptor. The functions of this module work on the pool attached last, a generator
+ * attached to several pools saves each attachment and restores it, before using that pool again.
+ */
+typedef struct pool_attachment {
+    sem_t *sem_pool;
+    int pool_fd;
+} pool_attachment;
+
+/**
+ * @brief Sets up the pool and returns the pointer to the shared memory.
+ *
+ * @details Errors, which may occur during these operations, are handled by this function and will terminate
+ * the program with EXIT_FAILURE and print an error message to stderr.
+ *
+ * @param ns the namespace, or NULL for the default names
+ * @return returns a pointer to the shared memory
+ */
+elite_pool *elite_pool_setup(const char *ns);
+
+/**
+ * @brief Attaches a generator to the pool of a running supervisor.
+ *
+ * @details A pool, whose size does not match yet, e.g. since the supervisor has not truncated it so far,
+ * is not mapped, so accessing it cannot raise SIGBUS.
+ *
+ * @param ns the namespace, or NULL for the default names
+ * @return returns a pointer to the shared memory, or NULL on error
+ */
+elite_pool *elite_pool_attach(const char *ns);
+
+/**
+ * @brief This function saves the attachment of the pool attached last by elite_pool_attach.
+ *
+ * @param attachment pointer to variable, which stores the attachment
+ */
+void elite_pool_save(pool_attachment *attachment);
+
+/**
+ * @brief This function restores a saved attachment, so the following calls work on its pool.
+ *
+ * @param attachment the attachment, saved by elite_pool_save
+ */
+void elite_pool_restore(const pool_attachment *attachment);
+
+/**
+ * @brief This function computes the key identifying a graph in the pool.
+ *
+ * @param gs the graph
+ * @return the key, never 0
+ */
+unsigned long long elite_pool_key(const graph_shm *gs);
+
+/**
+ * @brief This function offers a vertex order to the pool.
+ *
+ * @details Orders of graphs with more than POOL_MAX_VERTICES vertices are never accepted, and counted
+ * as oversized.
+ *
+ * @param p the pool
+ * @param gs the graph of the order
+ * @param key the key of gs
+ * @param order the vertex order
+ * @param fitness the number of backward edges of order
+ * @param worker the worker id of the caller
+ * @return 1 if the order was accepted, 0 otherwise
+ */
+int elite_pool_offer(elite_pool *p, const graph_shm *gs, unsigned long long key, const int *order, int fitness,
+                     int worker);
+
+/**
+ * @brief This function copies two different elites of the pool, drawn at random.
+ *
+ * @param p the pool
+ * @param gs the graph
+ * @param key the key of gs
+ * @param rng the random stream of the caller
+ * @param a buffer of size_v integers, receiving the first elite
+ * @param b buffer of size_v integers, receiving the second elite
+ * @return 0 on success, -1 if the pool holds less than two elites of gs
+ */
+int elite_pool_pick(elite_pool *p, const graph_shm *gs, unsigned long long key, rng_stream *rng, int *a, int *b);
+
+/**
+ * @brief This function fills the pool fields of a stats snapshot.
+ *
+ * @details Reads the pool without the semaphore, so the snapshot may mix two offers.
+ *
+ * @param p the pool
+ * @param rs the snapshot
+ */
+void elite_pool_stats(elite_pool *p, ring_stats *rs);
+
+/**
+ * @brief This function detaches from the pool, the supervisor also removes it.
+ *
+ * @param p the pool
+ * @param server specifies, whether the caller (1) is the supervisor or a generator (0)
+ */
+void elite_pool_destr(elite_pool *p, int server);
+
+#endif //FB_ARC_SET_ELITE_POOL_H
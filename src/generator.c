@@ -1,70 +1,54 @@
 /**
- * @file supervisor.c
+ * @file generator.c
  * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
  * @date 28.11.2023
  */
 
 #include <stdlib.h>
-#include <time.h>
 #include <errno.h>
+#include <time.h>
+#include <unistd.h>
 #include "graph_util.h"
 #include "circular_buffer.h"
+#include "graph_shm.h"
+#include "profile.h"
+#include "solver.h"
+#include "trace.h"
 
 /** the program name */
 const char *program_name;
 
+/**
+ * time in milliseconds, for which the generator retries to attach to the published graph, since the
+ * supervisor unlinks the old generation of an updated graph before publishing the new one
+ */
+#define ATTACH_RETRY_MS (1000)
+
 /**
  * @brief Prints a usage message to stderr, and terminates the program
  * with EXIT_FAILURE.
  */
 static void usage(void) {
-    fprintf(stderr, "usage: %s EDGE1 EDGE2 ...\n", program_name);
+    fprintf(stderr, "usage: %s [-c address | -x] [-s seed -r worker:iteration] [EDGE1 EDGE2 ...]\n", program_name);
     exit(EXIT_FAILURE);
 }
 
 /**
- * @brief Swaps the values of two indices in an array.
+ * @brief Attaches to the graph published by the supervisor, retrying for ATTACH_RETRY_MS milliseconds.
  *
- * @param arr the array
- * @param i first index
- * @param j second index
+ * @return the graph, or NULL if no graph was published within that time
  */
-static void swap(int **arr, int i, int j) {
-    int tmp = (*arr)[i];
-    (*arr)[i] = (*arr)[j];
-    (*arr)[j] = tmp;
-}
+static graph_shm *attach_graph(void) {
+    struct timespec wait = {.tv_sec = 0, .tv_nsec = 1000000};
 
-/**
- * @brief This function creates a random permutation of the vertices array in a graph g.
- *
- * @param g the specified graph
- */
-static void random_vertices_permutation(graph *g) {
-    for (int i = g->size_v - 1; i >= 0; --i) {
-        int j = rand() % (i + 1);
-        swap(&g->vertices, i, j);
-    }
-}
-
-/**
- * @brief Calculates a solution for the feedback arc set problem and adds it to a feedback arc graph
- *
- * @details This function iterates through the vertex list of graph g, which is a random
- * permutation created before calling this function.
- *
- * @param fb feedback arc graph, where edges are added to
- * @param g graph from which vertices and edges are read
- */
-static void add_fb_set_to_graph(graph *fb, graph *g) {
-    for (int i = g->size_v - 1; i > 0; i--) {
-        for (int j = i - 1; j >= 0; j--) {
-            edge e = edge_constr(g->vertices[i], g->vertices[j]);
-            if (graph_contains_edge(g,&e) == 1) {
-                graph_add(fb, &e);
-            }
+    for (int i = 0; i < ATTACH_RETRY_MS; i++) {
+        graph_shm *gs = graph_shm_attach(NULL);
+        if (gs != NULL) {
+            return gs;
         }
+        nanosleep(&wait, NULL);
     }
+    return NULL;
 }
 
 /**
@@ -72,46 +56,135 @@ static void add_fb_set_to_graph(graph *fb, graph *g) {
  * calculating possible solutions for the minimum feedback arc set problem, and writing
  * these solutions to the circular buffer.
  *
+ * @details Without edges, the generator attaches to the graph published by the supervisor.
+ * Otherwise the graph is read from the arguments and reduced to its kernel.
+ * [-c address] connects to a supervisor on another host, "tcp://host:port" or "unix:/path",
+ * instead of the shared memory, the graph has to be passed as arguments then.
+ * The random stream is taken from the supervisor, its seed and the worker id of this generator.
+ * [-x] runs in recombination mode, exchanging vertex orders with the elite pool of the supervisor.
+ * [-s seed -r worker:iteration] does not search, but replays the search of a worker of a run with this seed
+ * and prints the solution it wrote after that iteration, as reported by the supervisor.
+ *
  * @param argc argument counter
  * @param argv argument values
  * @return EXIT_SUCCESS on successful termination, otherwise EXIT_FAILURE
  */
 int main(int argc, char **argv) {
 
-    if (argc < 2) {
-        usage();
+    program_name = argv[0];
+
+    TRACE_INIT("generator");
+    profile_init("generator");
+
+    const char *address = NULL;
+    unsigned long long seed = 0;
+    int seeded = 0;
+    int worker = -1;
+    unsigned long long iteration = 0;
+    int recombine = 0;
+    int option_index;
+
+    while ((option_index = getopt(argc, argv, "c:s:r:x")) != -1) {
+        switch (option_index) {
+            case 'c':
+                address = optarg;
+                break;
+            case 's': {
+                char *endptr;
+                errno = 0;
+                seed = strtoull(optarg, &endptr, 0);
+                if (endptr == optarg || endptr[0] != '\0' || errno != 0) {
+                    usage();
+                }
+                seeded = 1;
+                break;
+            }
+            case 'x':
+                recombine = 1;
+                break;
+            case 'r':
+                if (sscanf(optarg, "%d:%llu", &worker, &iteration) != 2 || worker < 0) {
+                    usage();
+                }
+                break;
+            default:
+                usage();
+                break;
+        }
     }
 
-    program_name = argv[0];
+    int attach = optind == argc;
+    int replay = worker != -1;
+    if ((attach && address != NULL) || seeded != replay || (replay && address != NULL)
+        || (recombine && (address != NULL || replay))) {
+        usage();
+    }
 
-    srand((unsigned) time (NULL));
+    graph_shm *gs;
 
-    graph g = graph_constr();
+    if (attach) {
+        gs = attach_graph();
+        if (gs == NULL) {
+            fprintf(stderr, "%s: no graph published by the supervisor\n", program_name);
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        graph g = graph_constr();
 
-    for (int i = 1; i < argc; i++) {
-        int u, v;
-        if (sscanf(argv[i], "%d-%d", &u, &v) != 2) {
-            usage();
+        for (int i = optind; i < argc; i++) {
+            int u, v;
+            if (sscanf(argv[i], "%d-%d", &u, &v) != 2) {
+                usage();
+            }
+            edge e = edge_constr(u, v);
+            graph_add(&g, &e);
         }
-        edge e = edge_constr(u, v);
-        graph_add(&g, &e);
-    }
 
-    circular_buffer *cb = circular_buffer_setup(0);
+        graph_lift lift = graph_lift_constr();
+        graph kernel = graph_kernelize(&g, &lift);
+        gs = graph_shm_build(&kernel, &lift);
+        graph_destr(&kernel);
+        graph_lift_destr(&lift);
+        graph_destr(&g);
+    }
 
-    while (cb->terminate == 0) {
-        random_vertices_permutation(&g);
-        graph fb_arc_set = graph_constr();
-        add_fb_set_to_graph(&fb_arc_set, &g);
-        if (fb_arc_set.size_e <= MAX_EDGES) {
-            circular_buffer_write(cb, &fb_arc_set);
+    if (replay) {
+        graph fb = graph_constr();
+        if (solver_replay(gs, seed, worker, iteration, &fb) == -1) {
+            fprintf(stderr, "%s: error allocating memory\n", program_name);
+            exit(EXIT_FAILURE);
+        }
+        fprintf(stdout, "Solution with %d edges (worker %d, iteration %llu): ", fb.size_e, worker, iteration);
+        graph_print(&fb, stdout);
+        graph_destr(&fb);
+    } else {
+        circular_buffer *cb = address != NULL ? circular_buffer_connect(address)
+                                              : circular_buffer_setup(0, NULL, 0);
+
+        elite_pool *pool = NULL;
+        if (recombine && (pool = elite_pool_attach(NULL)) == NULL) {
+            fprintf(stderr, "%s: no elite pool set up by the supervisor, searching alone\n", program_name);
+        }
+        if (pool != NULL && gs->size_v > POOL_MAX_VERTICES) {
+            fprintf(stderr, "%s: kernel with %d vertices exceeds the elite pool of %d vertices, searching alone\n",
+                    program_name, gs->size_v, POOL_MAX_VERTICES);
         }
-    }
 
+        if (solver_run(cb, &gs, NULL, pool, 0) == -1) {
+            fprintf(stderr, "%s: error allocating memory\n", program_name);
+            exit(EXIT_FAILURE);
+        }
 
-    circular_buffer_destr(cb, 0);
+        if (pool != NULL) {
+            elite_pool_destr(pool, 0);
+        }
+        circular_buffer_destr(cb, 0);
+    }
 
-    graph_destr(&g);
+    if (attach) {
+        graph_shm_destr(gs, 0);
+    } else {
+        free(gs);
+    }
     return EXIT_SUCCESS;
 }
-
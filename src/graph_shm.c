@@ -0,0 +1,675 @@
+/**
+ * @file graph_shm.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The input graph, precomputed and published in shared memory.
+ */
+
+#include "graph_shm.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Prints an error message to stderr, and terminates the program
+ * with EXIT_FAILURE.
+ *
+ * @param message to be printed
+ */
+static void err_exit(char *message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Allocates memory by malloc(3), terminating the program with EXIT_FAILURE on error.
+ *
+ * @param size number of bytes
+ * @return the allocated memory
+ */
+static void *alloc_or_exit(size_t size) {
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == NULL) {
+        err_exit("error allocating memory");
+    }
+    return p;
+}
+
+/**
+ * @brief compares two integers, used by qsort(3) and bsearch(3).
+ */
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief compares two edges by (u, v), used by qsort(3).
+ */
+static int compare_edge(const void *a, const void *b) {
+    const edge *x = a;
+    const edge *y = b;
+    if (x->u != y->u) {
+        return (x->u > y->u) - (x->u < y->u);
+    }
+    return (x->v > y->v) - (x->v < y->v);
+}
+
+/**
+ * @brief This function returns the original ids of the vertices, indexed by dense id.
+ *
+ * @param gs the shared graph
+ * @return array of size_v original ids
+ */
+const int *graph_shm_ids(const graph_shm *gs) {
+    return gs->data;
+}
+
+/**
+ * @brief This function returns the component of every vertex, indexed by dense id.
+ *
+ * @param gs the shared graph
+ * @return array of size_v component numbers
+ */
+const int *graph_shm_scc(const graph_shm *gs) {
+    return gs->data + gs->size_v;
+}
+
+/**
+ * @brief This function returns the vertices, grouped by component in topological order.
+ *
+ * @param gs the shared graph
+ * @return array of size_v dense ids
+ */
+const int *graph_shm_order(const graph_shm *gs) {
+    return gs->data + 2 * gs->size_v;
+}
+
+/**
+ * @brief This function returns the offsets of the out edges of every vertex in the edge array.
+ *
+ * @param gs the shared graph
+ * @return array of size_v + 1 offsets
+ */
+const int *graph_shm_out_off(const graph_shm *gs) {
+    return gs->data + 3 * gs->size_v;
+}
+
+/**
+ * @brief This function returns the offsets of the components in the order array.
+ *
+ * @param gs the shared graph
+ * @return array of size_scc + 1 offsets
+ */
+const int *graph_shm_scc_off(const graph_shm *gs) {
+    return gs->data + 4 * gs->size_v + 1;
+}
+
+/**
+ * @brief This function returns the edges in dense ids, sorted by (u, v).
+ *
+ * @param gs the shared graph
+ * @return array of size_e edges
+ */
+const edge *graph_shm_edges(const graph_shm *gs) {
+    return (const edge *) (gs->data + 4 * gs->size_v + gs->size_scc + 2);
+}
+
+/**
+ * @brief This function returns the reduction steps, the graph is the kernel of.
+ *
+ * @param gs the shared graph
+ * @return array of size_lift reduction steps
+ */
+const reduction *graph_shm_lift(const graph_shm *gs) {
+    return (const reduction *) (graph_shm_edges(gs) + gs->size_e);
+}
+
+/**
+ * @brief This function numbers the strongly connected components of a graph, using an iterative
+ * version of Tarjan's algorithm.
+ *
+ * @details Tarjan's algorithm finds the components in reverse topological order, so the
+ * k-th component found out of n gets the number n - 1 - k.
+ *
+ * @param n number of vertices
+ * @param out_off offsets of the out edges of every vertex
+ * @param edges the edges, sorted by u
+ * @param scc output, the component of every vertex
+ * @return the number of components
+ */
+static int strongly_connected(int n, const int *out_off, const edge *edges, int *scc) {
+    int *index = alloc_or_exit(sizeof(int) * n);
+    int *low = alloc_or_exit(sizeof(int) * n);
+    int *iter = alloc_or_exit(sizeof(int) * n);
+    int *stack = alloc_or_exit(sizeof(int) * n);
+    int *call = alloc_or_exit(sizeof(int) * n);
+    char *on_stack = alloc_or_exit(n);
+    int next = 0, top = 0, found = 0;
+
+    for (int v = 0; v < n; v++) {
+        index[v] = -1;
+        on_stack[v] = 0;
+    }
+
+    for (int s = 0; s < n; s++) {
+        if (index[s] != -1) {
+            continue;
+        }
+
+        int depth = 0;
+        index[s] = low[s] = next++;
+        iter[s] = out_off[s];
+        stack[top++] = s;
+        on_stack[s] = 1;
+        call[depth++] = s;
+
+        while (depth > 0) {
+            int v = call[depth - 1];
+
+            if (iter[v] < out_off[v + 1]) {
+                int w = edges[iter[v]++].v;
+                if (index[w] == -1) {
+                    index[w] = low[w] = next++;
+                    iter[w] = out_off[w];
+                    stack[top++] = w;
+                    on_stack[w] = 1;
+                    call[depth++] = w;
+                } else if (on_stack[w] && index[w] < low[v]) {
+                    low[v] = index[w];
+                }
+                continue;
+            }
+
+            if (low[v] == index[v]) {
+                int w;
+                do {
+                    w = stack[--top];
+                    on_stack[w] = 0;
+                    scc[w] = found;
+                } while (w != v);
+                found++;
+            }
+
+            depth--;
+            if (depth > 0 && low[v] < low[call[depth - 1]]) {
+                low[call[depth - 1]] = low[v];
+            }
+        }
+    }
+
+    for (int v = 0; v < n; v++) {
+        scc[v] = found - 1 - scc[v];
+    }
+
+    free(index);
+    free(low);
+    free(iter);
+    free(stack);
+    free(call);
+    free(on_stack);
+
+    return found;
+}
+
+/**
+ * @brief This function builds the shared representation of graph g in memory allocated by malloc.
+ *
+ * @details Duplicate edges are removed. If an error occurs during memory allocation, the program
+ * terminates with EXIT_FAILURE. The result has to be released with free(3).
+ *
+ * @param g the graph
+ * @param lift the reduction steps, g is the kernel of, or NULL
+ * @return the shared representation of g
+ */
+graph_shm *graph_shm_build(graph *g, const graph_lift *lift) {
+    int n = g->size_v;
+    int *ids = alloc_or_exit(sizeof(int) * n);
+    memcpy(ids, g->vertices, sizeof(int) * n);
+    qsort(ids, n, sizeof(int), compare_int);
+
+    edge *edges = alloc_or_exit(sizeof(edge) * g->size_e);
+    for (int i = 0; i < g->size_e; i++) {
+        int *u = bsearch(&g->edges[i].u, ids, n, sizeof(int), compare_int);
+        int *v = bsearch(&g->edges[i].v, ids, n, sizeof(int), compare_int);
+        edges[i] = edge_constr((int) (u - ids), (int) (v - ids));
+    }
+    qsort(edges, g->size_e, sizeof(edge), compare_edge);
+
+    int m = 0;
+    for (int i = 0; i < g->size_e; i++) {
+        if (m == 0 || compare_edge(&edges[m - 1], &edges[i]) != 0) {
+            edges[m++] = edges[i];
+        }
+    }
+
+    int *out_off = alloc_or_exit(sizeof(int) * (n + 1));
+    for (int v = 0, i = 0; v <= n; v++) {
+        while (i < m && edges[i].u < v) {
+            i++;
+        }
+        out_off[v] = i;
+    }
+
+    int *scc = alloc_or_exit(sizeof(int) * n);
+    int size_scc = strongly_connected(n, out_off, edges, scc);
+
+    int size_lift = lift != NULL ? lift->size : 0;
+    size_t size = sizeof(graph_shm) + sizeof(int) * (4 * n + size_scc + 2) + sizeof(edge) * m
+                  + sizeof(reduction) * size_lift;
+    graph_shm *gs = alloc_or_exit(size);
+    memset(gs, 0, size);
+    gs->magic = GRAPH_SHM_MAGIC;
+    gs->version = GRAPH_SHM_VERSION;
+    gs->size_v = n;
+    gs->size_e = m;
+    gs->size_scc = size_scc;
+    gs->size_lift = size_lift;
+    gs->size_forced = lift != NULL ? lift->forced : 0;
+    gs->size = size;
+
+    int *data = gs->data;
+    memcpy(data, ids, sizeof(int) * n);
+    memcpy(data + n, scc, sizeof(int) * n);
+    memcpy(data + 3 * n, out_off, sizeof(int) * (n + 1));
+    memcpy((edge *) (data + 4 * n + size_scc + 2), edges, sizeof(edge) * m);
+    if (size_lift > 0) {
+        memcpy((reduction *) graph_shm_lift(gs), lift->steps, sizeof(reduction) * size_lift);
+    }
+
+    int *order = data + 2 * n;
+    int *scc_off = data + 4 * n + 1;
+    for (int v = 0; v < n; v++) {
+        scc_off[scc[v] + 1]++;
+    }
+    for (int c = 0; c < size_scc; c++) {
+        scc_off[c + 1] += scc_off[c];
+    }
+    int *fill = alloc_or_exit(sizeof(int) * (size_scc + 1));
+    memcpy(fill, scc_off, sizeof(int) * (size_scc + 1));
+    for (int v = 0; v < n; v++) {
+        order[fill[scc[v]]++] = v;
+    }
+
+    free(fill);
+    free(scc);
+    free(out_off);
+    free(edges);
+    free(ids);
+
+    return gs;
+}
+
+/**
+ * @brief the index of the published graph, a shared memory object under the name of the graph itself.
+ * generation is the generation of the current segment, which is named after the graph and its generation
+ * (see segment_name). magic is written last, once the index is valid.
+ */
+typedef struct graph_shm_index {
+    int magic;
+    int version;
+    int generation;
+} graph_shm_index;
+
+/**
+ * @brief This function writes the name of the segment holding a generation of the graph to buf.
+ *
+ * @param buf buffer of NAME_LEN characters
+ * @param name the name of the graph
+ * @param generation the generation
+ */
+static void segment_name(char *buf, const char *name, int generation) {
+    snprintf(buf, NAME_LEN, "%s.%d", name, generation);
+}
+
+/**
+ * @brief This function maps the index of the graph named name.
+ *
+ * @param name the name of the graph
+ * @param create specifies, whether the index is created read-write (1) or opened read-only (0)
+ * @return the index, or NULL if it cannot be opened read-only. Errors during creation terminate the program.
+ */
+static graph_shm_index *index_map(const char *name, int create) {
+    int fd = shm_open(name, create ? O_CREAT | O_RDWR : O_RDONLY, 0600);
+    if (fd == -1) {
+        if (!create) {
+            return NULL;
+        }
+        err_exit("error opening graph shm index");
+    }
+
+    if (create && ftruncate(fd, sizeof(graph_shm_index)) < 0) {
+        close(fd);
+        shm_unlink(name);
+        err_exit("error during ftruncate of graph shm index");
+    }
+
+    struct stat st;
+    if (!create && (fstat(fd, &st) == -1 || (size_t) st.st_size != sizeof(graph_shm_index))) {
+        close(fd);
+        return NULL;
+    }
+
+    graph_shm_index *idx = mmap(NULL, sizeof(graph_shm_index), create ? PROT_READ | PROT_WRITE : PROT_READ,
+                                MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (idx == MAP_FAILED) {
+        if (!create) {
+            return NULL;
+        }
+        shm_unlink(name);
+        err_exit("mapping graph shm index failed");
+    }
+
+    return idx;
+}
+
+/**
+ * @brief This function points the index of the graph named name to a generation.
+ *
+ * @details Generators attaching afterwards map this generation. Errors terminate the program.
+ *
+ * @param name the name of the graph
+ * @param generation the generation, whose segment is completely published
+ */
+static void index_point(const char *name, int generation) {
+    graph_shm_index *idx = index_map(name, 1);
+
+    idx->version = GRAPH_SHM_VERSION;
+    __atomic_store_n(&idx->generation, generation, __ATOMIC_RELEASE);
+    __atomic_store_n(&idx->magic, GRAPH_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    munmap(idx, sizeof(graph_shm_index));
+}
+
+/**
+ * @brief This function creates the segment of the generation in built and copies built into it.
+ *
+ * @details magic is written last with release semantics, so a generator attaching to the segment before
+ * the copy has finished rejects it. Errors are handled like in graph_shm_publish, built is released in any case.
+ *
+ * @param built the shared representation, as returned by graph_shm_build
+ * @return the published graph, mapped read-write
+ */
+static graph_shm *graph_shm_create(graph_shm *built) {
+    char name[NAME_LEN];
+    segment_name(name, built->name, built->generation);
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+    if (fd == -1) {
+        free(built);
+        err_exit("error opening graph shm");
+    }
+
+    if (ftruncate(fd, (off_t) built->size) < 0) {
+        close(fd);
+        shm_unlink(name);
+        free(built);
+        err_exit("error during ftruncate of graph shm");
+    }
+
+    graph_shm *gs = mmap(NULL, built->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (gs == MAP_FAILED) {
+        close(fd);
+        shm_unlink(name);
+        free(built);
+        err_exit("mapping graph shm failed");
+    }
+
+    if (close(fd) == -1) {
+        err_exit("failed to close graph shm file descriptor");
+    }
+
+    size_t skip = offsetof(graph_shm, version);
+    memcpy((char *) gs + skip, (char *) built + skip, built->size - skip);
+    __atomic_store_n(&gs->magic, GRAPH_SHM_MAGIC, __ATOMIC_RELEASE);
+    free(built);
+
+    return gs;
+}
+
+/**
+ * @brief This function builds the shared representation of graph g and publishes it in shared memory.
+ *
+ * @details Errors, which may occur during these operations, are handled by this function and will terminate
+ * the program with EXIT_FAILURE and print an error message to stderr.
+ *
+ * @param g the graph
+ * @param lift the reduction steps, g is the kernel of, or NULL
+ * @param ns the namespace, or NULL for the default name
+ * @return the published graph, mapped read-write
+ */
+graph_shm *graph_shm_publish(graph *g, const graph_lift *lift, const char *ns) {
+    graph_shm *built = graph_shm_build(g, lift);
+    namespace_name(built->name, ns, GRAPH_SHM_NAME);
+
+    graph_shm *gs = graph_shm_create(built);
+    index_point(gs->name, gs->generation);
+
+    return gs;
+}
+
+/**
+ * @brief This function publishes the next generation of a graph and marks the old one as stale.
+ *
+ * @details The new segment is created and the index pointed to it, before the old segment is marked stale,
+ * unmapped and unlinked, so the graph can be attached at any time. Generators still attached to the old
+ * segment see stale being set and attach to the new one. Errors are handled like in graph_shm_publish.
+ *
+ * @param old the currently published graph
+ * @param g the changed graph
+ * @param lift the reduction steps, g is the kernel of, or NULL
+ * @return the newly published graph, mapped read-write
+ */
+graph_shm *graph_shm_update(graph_shm *old, graph *g, const graph_lift *lift) {
+    graph_shm *built = graph_shm_build(g, lift);
+    memcpy(built->name, old->name, NAME_LEN);
+    built->generation = old->generation + 1;
+
+    graph_shm *gs = graph_shm_create(built);
+    index_point(gs->name, gs->generation);
+
+    char name[NAME_LEN];
+    segment_name(name, old->name, old->generation);
+
+    __atomic_store_n(&old->stale, 1, __ATOMIC_RELEASE);
+    munmap(old, old->size);
+    shm_unlink(name);
+
+    return gs;
+}
+
+/**
+ * @brief This function checks, whether a newer generation of the graph has been published.
+ *
+ * @param gs the shared graph
+ * @return 1, if gs is stale, 0 otherwise
+ */
+int graph_shm_stale(const graph_shm *gs) {
+    return __atomic_load_n(&gs->stale, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief This function attaches to the graph published by the supervisor.
+ *
+ * @details The index is read first, then the segment of the generation it points to is mapped.
+ *
+ * @param ns the namespace, or NULL for the default name
+ * @return the published graph, mapped read-only, or NULL if no valid graph is published
+ */
+graph_shm *graph_shm_attach(const char *ns) {
+    char name[NAME_LEN];
+    namespace_name(name, ns, GRAPH_SHM_NAME);
+
+    graph_shm_index *idx = index_map(name, 0);
+    if (idx == NULL) {
+        return NULL;
+    }
+
+    int valid = __atomic_load_n(&idx->magic, __ATOMIC_ACQUIRE) == GRAPH_SHM_MAGIC
+                && idx->version == GRAPH_SHM_VERSION;
+    int generation = __atomic_load_n(&idx->generation, __ATOMIC_ACQUIRE);
+    munmap(idx, sizeof(graph_shm_index));
+
+    if (!valid) {
+        return NULL;
+    }
+
+    char segment[NAME_LEN];
+    segment_name(segment, name, generation);
+
+    int fd = shm_open(segment, O_RDONLY, 0);
+    if (fd == -1) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t) st.st_size < sizeof(graph_shm)) {
+        close(fd);
+        return NULL;
+    }
+
+    graph_shm *gs = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (gs == MAP_FAILED) {
+        return NULL;
+    }
+
+    if (__atomic_load_n(&gs->magic, __ATOMIC_ACQUIRE) != GRAPH_SHM_MAGIC || gs->version != GRAPH_SHM_VERSION
+        || gs->size != (size_t) st.st_size) {
+        munmap(gs, (size_t) st.st_size);
+        return NULL;
+    }
+
+    return gs;
+}
+
+/**
+ * @brief This function unmaps the shared graph, the server also unlinks it and its index.
+ *
+ * @param gs the shared graph
+ * @param server specifies, whether the caller (1) is the server or a client (0)
+ */
+void graph_shm_destr(graph_shm *gs, int server) {
+    char name[NAME_LEN];
+    char segment[NAME_LEN];
+    memcpy(name, gs->name, NAME_LEN);
+    segment_name(segment, name, gs->generation);
+
+    munmap(gs, gs->size);
+
+    if (server == 1) {
+        shm_unlink(segment);
+        shm_unlink(name);
+    }
+}
+
+/**
+ * @brief This function returns the dense id of a vertex.
+ *
+ * @param gs the shared graph
+ * @param id original id of the vertex
+ * @return the dense id, or -1 if the vertex is not contained in the graph
+ */
+int graph_shm_find(const graph_shm *gs, int id) {
+    const int *ids = graph_shm_ids(gs);
+    const int *found = bsearch(&id, ids, gs->size_v, sizeof(int), compare_int);
+    return found == NULL ? -1 : (int) (found - ids);
+}
+
+/**
+ * @brief This function returns the index of the edge u -> v in the edge array.
+ *
+ * @param gs the shared graph
+ * @param u dense id of vertex u
+ * @param v dense id of vertex v
+ * @return the index of the edge, or -1 if it is not contained in the graph
+ */
+static int graph_shm_find_edge(const graph_shm *gs, int u, int v) {
+    const int *out_off = graph_shm_out_off(gs);
+    const edge *edges = graph_shm_edges(gs);
+    int lo = out_off[u], hi = out_off[u + 1];
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (edges[mid].v < v) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo < out_off[u + 1] && edges[lo].v == v ? lo : -1;
+}
+
+/**
+ * @brief This function checks, whether removing the edges of fb from the graph makes it acyclic.
+ *
+ * @details Uses Kahn's algorithm, the remaining graph is acyclic, if every vertex can be removed
+ * in topological order.
+ *
+ * @param gs the shared graph
+ * @param fb feedback arc set, in original ids
+ * @return 1, if fb is a feedback arc set of the graph, 0 otherwise
+ */
+int graph_shm_is_fas(const graph_shm *gs, graph *fb) {
+    int n = gs->size_v;
+    const int *out_off = graph_shm_out_off(gs);
+    const edge *edges = graph_shm_edges(gs);
+    char *removed = alloc_or_exit(gs->size_e);
+    int *in_deg = alloc_or_exit(sizeof(int) * n);
+    int *queue = alloc_or_exit(sizeof(int) * n);
+    int valid = 1;
+
+    memset(removed, 0, gs->size_e);
+    memset(in_deg, 0, sizeof(int) * n);
+
+    for (int i = 0; i < fb->size_e && valid; i++) {
+        int u = graph_shm_find(gs, fb->edges[i].u);
+        int v = graph_shm_find(gs, fb->edges[i].v);
+        int k = u == -1 || v == -1 ? -1 : graph_shm_find_edge(gs, u, v);
+        if (k == -1) {
+            valid = 0;
+        } else {
+            removed[k] = 1;
+        }
+    }
+
+    if (valid) {
+        for (int k = 0; k < gs->size_e; k++) {
+            if (!removed[k]) {
+                in_deg[edges[k].v]++;
+            }
+        }
+
+        int head = 0, tail = 0;
+        for (int v = 0; v < n; v++) {
+            if (in_deg[v] == 0) {
+                queue[tail++] = v;
+            }
+        }
+        while (head < tail) {
+            int u = queue[head++];
+            for (int k = out_off[u]; k < out_off[u + 1]; k++) {
+                if (!removed[k] && --in_deg[edges[k].v] == 0) {
+                    queue[tail++] = edges[k].v;
+                }
+            }
+        }
+        valid = tail == n;
+    }
+
+    free(removed);
+    free(in_deg);
+    free(queue);
+
+    return valid;
+}
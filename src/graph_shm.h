@@ -0,0 +1,201 @@
+/**
+ * @file graph_shm.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the shared input graph, implemented by @file graph_shm.c
+ *
+ * @details The supervisor loads the input graph once, precomputes a compact representation of it
+ * and publishes it in shared memory. Generators attach to it read-only, instead of parsing
+ * the graph from their arguments.
+ *
+ * The vertices are renumbered to dense ids 0 .. size_v - 1 in ascending order of their original ids.
+ * The edges are stored sorted by (u, v) in dense ids, out_off[u] .. out_off[u + 1] being the out edges of u.
+ * The strongly connected components are numbered in topological order and order lists
+ * the vertices grouped by their component, scc_off[c] .. scc_off[c + 1] being the vertices of component c.
+ *
+ * The supervisor publishes the kernel of its input graph (see graph_kernelize), followed by the reduction
+ * steps, so generators lift their solutions to the input graph before writing them.
+ *
+ * Each generation of the graph is published in a segment of its own, named after the graph and the generation,
+ * e.g. /11806442_graph.0. A small index under the name of the graph holds the current generation.
+ * A published graph is never modified. When the graph changes, the supervisor publishes the next generation,
+ * points the index to it and only then sets stale in the old segment and unlinks it, so generators reattach.
+ */
+
+#ifndef FB_ARC_SET_GRAPH_SHM_H
+#define FB_ARC_SET_GRAPH_SHM_H
+
+#include <stddef.h>
+#include "graph_util.h"
+#include "namespace.h"
+
+/**
+ * shared memory name of the published graph (see namespace.h), its magic number and layout version
+ */
+#define GRAPH_SHM_NAME "graph"
+#define GRAPH_SHM_MAGIC (0x46415347)
+#define GRAPH_SHM_VERSION (3)
+
+/**
+ * @brief the header of the shared graph, followed by its arrays.
+ * size is the total size in bytes, including the header, name the full name of the graph (see namespace.h).
+ * magic is written last, once the segment is completely published.
+ * stale is set by the supervisor, once a newer generation of the graph has been published.
+ * size_lift is the number of reduction steps, size_forced the number of forced edges among them.
+ */
+typedef struct graph_shm {
+    int magic;
+    int version;
+    char name[NAME_LEN];
+    int generation;
+    int stale;
+    int size_v;
+    int size_e;
+    int size_scc;
+    int size_lift;
+    int size_forced;
+    size_t size;
+    int data[];
+} graph_shm;
+
+/**
+ * @brief This function builds the shared representation of graph g in memory allocated by malloc.
+ *
+ * @details Duplicate edges are removed. If an error occurs during memory allocation, the program
+ * terminates with EXIT_FAILURE. The result has to be released with free(3).
+ *
+ * @param g the graph
+ * @param lift the reduction steps, g is the kernel of, or NULL
+ * @return the shared representation of g
+ */
+graph_shm *graph_shm_build(graph *g, const graph_lift *lift);
+
+/**
+ * @brief This function builds the shared representation of graph g and publishes it in shared memory.
+ *
+ * @details Errors, which may occur during these operations, are handled by this function and will terminate
+ * the program with EXIT_FAILURE and print an error message to stderr.
+ *
+ * @param g the graph
+ * @param lift the reduction steps, g is the kernel of, or NULL
+ * @param ns the namespace, or NULL for the default name
+ * @return the published graph, mapped read-write
+ */
+graph_shm *graph_shm_publish(graph *g, const graph_lift *lift, const char *ns);
+
+/**
+ * @brief This function publishes the next generation of a graph and marks the old one as stale.
+ *
+ * @details The new segment is created and the index pointed to it, before the old segment is marked stale,
+ * unmapped and unlinked, so the graph can be attached at any time. Generators still attached to the old
+ * segment see stale being set and attach to the new one. Errors are handled like in graph_shm_publish.
+ *
+ * @param old the currently published graph
+ * @param g the changed graph
+ * @param lift the reduction steps, g is the kernel of, or NULL
+ * @return the newly published graph, mapped read-write
+ */
+graph_shm *graph_shm_update(graph_shm *old, graph *g, const graph_lift *lift);
+
+/**
+ * @brief This function checks, whether a newer generation of the graph has been published.
+ *
+ * @param gs the shared graph
+ * @return 1, if gs is stale, 0 otherwise
+ */
+int graph_shm_stale(const graph_shm *gs);
+
+/**
+ * @brief This function attaches to the graph published by the supervisor.
+ *
+ * @details The index is read first, then the segment of the generation it points to is mapped.
+ *
+ * @param ns the namespace, or NULL for the default name
+ * @return the published graph, mapped read-only, or NULL if no valid graph is published
+ */
+graph_shm *graph_shm_attach(const char *ns);
+
+/**
+ * @brief This function unmaps the shared graph, the server also unlinks it and its index.
+ *
+ * @param gs the shared graph
+ * @param server specifies, whether the caller (1) is the server or a client (0)
+ */
+void graph_shm_destr(graph_shm *gs, int server);
+
+/**
+ * @brief This function returns the original ids of the vertices, indexed by dense id.
+ *
+ * @param gs the shared graph
+ * @return array of size_v original ids
+ */
+const int *graph_shm_ids(const graph_shm *gs);
+
+/**
+ * @brief This function returns the component of every vertex, indexed by dense id.
+ *
+ * @param gs the shared graph
+ * @return array of size_v component numbers
+ */
+const int *graph_shm_scc(const graph_shm *gs);
+
+/**
+ * @brief This function returns the vertices, grouped by component in topological order.
+ *
+ * @param gs the shared graph
+ * @return array of size_v dense ids
+ */
+const int *graph_shm_order(const graph_shm *gs);
+
+/**
+ * @brief This function returns the offsets of the components in the order array.
+ *
+ * @param gs the shared graph
+ * @return array of size_scc + 1 offsets
+ */
+const int *graph_shm_scc_off(const graph_shm *gs);
+
+/**
+ * @brief This function returns the offsets of the out edges of every vertex in the edge array.
+ *
+ * @param gs the shared graph
+ * @return array of size_v + 1 offsets
+ */
+const int *graph_shm_out_off(const graph_shm *gs);
+
+/**
+ * @brief This function returns the edges in dense ids, sorted by (u, v).
+ *
+ * @param gs the shared graph
+ * @return array of size_e edges
+ */
+const edge *graph_shm_edges(const graph_shm *gs);
+
+/**
+ * @brief This function returns the reduction steps, the graph is the kernel of.
+ *
+ * @param gs the shared graph
+ * @return array of size_lift reduction steps
+ */
+const reduction *graph_shm_lift(const graph_shm *gs);
+
+/**
+ * @brief This function returns the dense id of a vertex.
+ *
+ * @param gs the shared graph
+ * @param id original id of the vertex
+ * @return the dense id, or -1 if the vertex is not contained in the graph
+ */
+int graph_shm_find(const graph_shm *gs, int id);
+
+/**
+ * @brief This function checks, whether removing the edges of fb from the graph makes it acyclic.
+ *
+ * @param gs the shared graph
+ * @param fb feedback arc set, in original ids
+ * @return 1, if fb is a feedback arc set of the graph, 0 otherwise
+ */
+int graph_shm_is_fas(const graph_shm *gs, graph *fb);
+
+#endif //FB_ARC_SET_GRAPH_SHM_H
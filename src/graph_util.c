@@ -6,6 +6,7 @@
 
 #include "graph_util.h"
 #include <stdlib.h>
+#include <string.h>
 
 #define INITIAL_CAPACITY (8)
 
@@ -151,7 +152,7 @@ int graph_contains_edge(graph *g, edge *e) {
  * @return 1, if graph g contains vertex, 0 otherwise
  */
 static int graph_contains_vertex(graph *g, int vertex) {
-    for (int i = 0; i < g->capacity_v; i++) {
+    for (int i = 0; i < g->size_v; i++) {
         if (g->vertices[i] == vertex) {
             return 1;
         }
@@ -192,6 +193,429 @@ void graph_add(graph *g, edge *e) {
     }
 }
 
+/**
+ * @brief This function removes every occurrence of an edge e from a graph g.
+ * Vertices are kept, even if no edge is left at them.
+ *
+ * @param g Graph, from which edge e shall be removed
+ * @param e Edge, to be removed from graph g
+ * @return 1, if graph g contained edge e, 0 otherwise
+ */
+int graph_remove(graph *g, edge *e) {
+    int found = 0;
+
+    for (int i = 0; i < g->size_e; i++) {
+        if (g->edges[i].u == e->u && g->edges[i].v == e->v) {
+            g->edges[i--] = g->edges[--g->size_e];
+            found = 1;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief This function reads edges from the specified input and adds them to a graph g.
+ *
+ * @details The edges are separated by whitespace, each of them written as u-v, e.g. 0-1 1-2 2-0
+ *
+ * @param g Graph, to which the edges are added
+ * @param input the input file
+ * @return 0 on success, -1 if the input contains a malformed edge
+ */
+int graph_read(graph *g, FILE *input) {
+    int u, v, n;
+
+    while ((n = fscanf(input, " %d-%d", &u, &v)) == 2) {
+        edge e = edge_constr(u, v);
+        graph_add(g, &e);
+    }
+
+    return n == EOF && !ferror(input) ? 0 : -1;
+}
+
+/**
+ * @brief compares two integers, used by qsort(3) and bsearch(3).
+ */
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief compares two edges by (u, v), used by qsort(3).
+ */
+static int compare_edge(const void *a, const void *b) {
+    const edge *x = a;
+    const edge *y = b;
+    if (x->u != y->u) {
+        return (x->u > y->u) - (x->u < y->u);
+    }
+    return (x->v > y->v) - (x->v < y->v);
+}
+
+/**
+ * @brief Allocates memory by malloc(3), terminating the program with EXIT_FAILURE on error.
+ *
+ * @param size number of bytes
+ * @return the allocated memory
+ */
+static void *alloc_or_exit(size_t size) {
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == NULL) {
+        error_and_exit("error allocating memory");
+    }
+    return p;
+}
+
+/**
+ * @brief This function returns an empty list of reduction steps.
+ *
+ * @details If an error occurs during memory allocation, the program terminates with EXIT_FAILURE.
+ *
+ * @return an empty lift
+ */
+graph_lift graph_lift_constr(void) {
+    graph_lift lift;
+    lift.size = 0;
+    lift.capacity = INITIAL_CAPACITY;
+    lift.forced = 0;
+    lift.steps = alloc_or_exit(sizeof(reduction) * lift.capacity);
+
+    return lift;
+}
+
+/**
+ * @brief This function frees any memory that was allocated to the lift.
+ *
+ * @param lift lift to be destructed
+ */
+void graph_lift_destr(graph_lift *lift) {
+    free(lift->steps);
+}
+
+/**
+ * @brief Appends a reduction step to a lift.
+ *
+ * @param lift the lift
+ * @param type the type of the step
+ * @param e the forced edge, or the edge of the kernel replacing the bypassed path
+ * @param lifted the edge, e is lifted to
+ */
+static void lift_add(graph_lift *lift, int type, edge e, edge lifted) {
+    if (lift->size == lift->capacity) {
+        reduction *steps = realloc(lift->steps, sizeof(reduction) * lift->capacity * 2);
+        if (steps == NULL) {
+            error_and_exit("error resizing array");
+        }
+        lift->steps = steps;
+        lift->capacity *= 2;
+    }
+
+    reduction *r = &lift->steps[lift->size++];
+    r->type = type;
+    r->e = e;
+    r->lifted = lifted;
+    if (type == REDUCTION_FORCE) {
+        lift->forced++;
+    }
+}
+
+/**
+ * @brief the working state of graph_kernelize, in dense vertex ids.
+ * Edges keep their index, a bypass redirects the in-edge of the bypassed vertex, so out and in hold
+ * the edge indices of every vertex in CSR form, some of which may no longer be alive or incident.
+ */
+typedef struct kernel_state {
+    int *ids;
+    edge *edges;
+    char *alive;
+    int *out_off;
+    int *out;
+    int *in_off;
+    int *in;
+    int *in_deg;
+    int *out_deg;
+    int *queue;
+    char *queued;
+    int head;
+    int queued_n;
+    int n;
+} kernel_state;
+
+/**
+ * @brief Schedules vertex v to be checked by the reduction rules again.
+ *
+ * @param ks the kernel state
+ * @param v the vertex
+ */
+static void kernel_push(kernel_state *ks, int v) {
+    if (!ks->queued[v]) {
+        ks->queued[v] = 1;
+        ks->queue[(ks->head + ks->queued_n++) % ks->n] = v;
+    }
+}
+
+/**
+ * @brief Removes an edge from the kernel and schedules its endpoints.
+ *
+ * @param ks the kernel state
+ * @param k index of the edge
+ */
+static void kernel_kill(kernel_state *ks, int k) {
+    ks->alive[k] = 0;
+    ks->out_deg[ks->edges[k].u]--;
+    ks->in_deg[ks->edges[k].v]--;
+    kernel_push(ks, ks->edges[k].u);
+    kernel_push(ks, ks->edges[k].v);
+}
+
+/**
+ * @brief Returns the first alive in-edge of v.
+ *
+ * @param ks the kernel state
+ * @param v the vertex
+ * @return index of the edge, or -1 if there is none
+ */
+static int kernel_in_edge(kernel_state *ks, int v) {
+    for (int i = ks->in_off[v]; i < ks->in_off[v + 1]; i++) {
+        int k = ks->in[i];
+        if (ks->alive[k] && ks->edges[k].v == v) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the alive edge u -> v.
+ *
+ * @param ks the kernel state
+ * @param u the first vertex
+ * @param v the second vertex, or -1 for any vertex
+ * @return index of the edge, or -1 if there is none
+ */
+static int kernel_out_edge(kernel_state *ks, int u, int v) {
+    for (int i = ks->out_off[u]; i < ks->out_off[u + 1]; i++) {
+        int k = ks->out[i];
+        if (ks->alive[k] && (v == -1 || ks->edges[k].v == v)) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Forces an edge into the feedback arc set and removes it from the kernel.
+ *
+ * @param ks the kernel state
+ * @param lift the lift
+ * @param k index of the edge
+ */
+static void kernel_force(kernel_state *ks, graph_lift *lift, int k) {
+    edge e = edge_constr(ks->ids[ks->edges[k].u], ks->ids[ks->edges[k].v]);
+    lift_add(lift, REDUCTION_FORCE, e, e);
+    kernel_kill(ks, k);
+}
+
+/**
+ * @brief Applies the first matching reduction rule to vertex v.
+ *
+ * @param ks the kernel state
+ * @param lift the lift
+ * @param v the vertex
+ */
+static void kernel_reduce(kernel_state *ks, graph_lift *lift, int v) {
+    if (ks->in_deg[v] == 0 && ks->out_deg[v] == 0) {
+        return;
+    }
+
+    if (ks->in_deg[v] == 0 || ks->out_deg[v] == 0) {
+        int k;
+        while ((k = kernel_out_edge(ks, v, -1)) != -1) {
+            kernel_kill(ks, k);
+        }
+        while ((k = kernel_in_edge(ks, v)) != -1) {
+            kernel_kill(ks, k);
+        }
+        return;
+    }
+
+    int a = ks->in_deg[v] == 1 ? kernel_in_edge(ks, v) : -1;
+    if (a != -1 && kernel_out_edge(ks, v, ks->edges[a].u) != -1) {
+        kernel_force(ks, lift, a);
+        return;
+    }
+
+    int b = ks->out_deg[v] == 1 ? kernel_out_edge(ks, v, -1) : -1;
+    if (b != -1 && kernel_out_edge(ks, ks->edges[b].v, v) != -1) {
+        kernel_force(ks, lift, b);
+        return;
+    }
+
+    if (a != -1 && b != -1) {
+        int u = ks->edges[a].u;
+        int w = ks->edges[b].v;
+
+        if (kernel_out_edge(ks, u, w) == -1) {
+            lift_add(lift, REDUCTION_BYPASS, edge_constr(ks->ids[u], ks->ids[w]),
+                     edge_constr(ks->ids[u], ks->ids[v]));
+
+            ks->edges[a].v = w;
+            ks->alive[b] = 0;
+            for (int i = ks->in_off[w]; i < ks->in_off[w + 1]; i++) {
+                if (ks->in[i] == b) {
+                    ks->in[i] = a;
+                }
+            }
+            ks->in_deg[v] = 0;
+            ks->out_deg[v] = 0;
+            kernel_push(ks, u);
+            kernel_push(ks, w);
+        }
+    }
+}
+
+/**
+ * @brief This function reduces a graph g to its kernel, by applying reduction rules until none applies.
+ *
+ * @details Self loops are forced. A vertex with in-degree or out-degree 0 is removed. If the only in-edge
+ * of a vertex comes from u and the vertex also has an edge to u, the in-edge is forced, since it breaks every
+ * cycle through the vertex, in particular the 2-cycle with u. Likewise for the only out-edge. A vertex with
+ * one in-edge u -> x and one out-edge x -> w is bypassed by u -> w, unless that edge already exists.
+ * Duplicate edges are removed. The applied steps are appended to lift, so a feedback arc set of the kernel
+ * is lifted to a feedback arc set of g of the same size plus the forced edges, by graph_lift_solution.
+ *
+ * @param g the graph, which is not modified
+ * @param lift the lift, where the reduction steps are appended to
+ * @return the kernel
+ */
+graph graph_kernelize(graph *g, graph_lift *lift) {
+    kernel_state ks;
+    int n = g->size_v;
+    int m = 0;
+
+    ks.n = n > 0 ? n : 1;
+    ks.ids = alloc_or_exit(sizeof(int) * n);
+    memcpy(ks.ids, g->vertices, sizeof(int) * n);
+    qsort(ks.ids, n, sizeof(int), compare_int);
+
+    ks.edges = alloc_or_exit(sizeof(edge) * g->size_e);
+    for (int i = 0; i < g->size_e; i++) {
+        int *u = bsearch(&g->edges[i].u, ks.ids, n, sizeof(int), compare_int);
+        int *v = bsearch(&g->edges[i].v, ks.ids, n, sizeof(int), compare_int);
+        ks.edges[i] = edge_constr((int) (u - ks.ids), (int) (v - ks.ids));
+    }
+    qsort(ks.edges, g->size_e, sizeof(edge), compare_edge);
+    for (int i = 0; i < g->size_e; i++) {
+        if (m == 0 || compare_edge(&ks.edges[m - 1], &ks.edges[i]) != 0) {
+            ks.edges[m++] = ks.edges[i];
+        }
+    }
+
+    ks.alive = alloc_or_exit(m);
+    ks.out_off = alloc_or_exit(sizeof(int) * (n + 1));
+    ks.in_off = alloc_or_exit(sizeof(int) * (n + 1));
+    ks.out = alloc_or_exit(sizeof(int) * m);
+    ks.in = alloc_or_exit(sizeof(int) * m);
+    ks.in_deg = alloc_or_exit(sizeof(int) * n);
+    ks.out_deg = alloc_or_exit(sizeof(int) * n);
+    ks.queue = alloc_or_exit(sizeof(int) * ks.n);
+    ks.queued = alloc_or_exit(ks.n);
+    ks.head = 0;
+    ks.queued_n = 0;
+
+    memset(ks.out_off, 0, sizeof(int) * (n + 1));
+    memset(ks.in_off, 0, sizeof(int) * (n + 1));
+    memset(ks.in_deg, 0, sizeof(int) * n);
+    memset(ks.out_deg, 0, sizeof(int) * n);
+    memset(ks.queued, 0, ks.n);
+
+    for (int k = 0; k < m; k++) {
+        ks.out_off[ks.edges[k].u + 1]++;
+        ks.in_off[ks.edges[k].v + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        ks.out_off[v + 1] += ks.out_off[v];
+        ks.in_off[v + 1] += ks.in_off[v];
+    }
+    for (int k = 0; k < m; k++) {
+        ks.out[k] = k;
+        ks.alive[k] = 1;
+        ks.out_deg[ks.edges[k].u]++;
+        ks.in_deg[ks.edges[k].v]++;
+    }
+    int *fill = alloc_or_exit(sizeof(int) * (n + 1));
+    memcpy(fill, ks.in_off, sizeof(int) * (n + 1));
+    for (int k = 0; k < m; k++) {
+        ks.in[fill[ks.edges[k].v]++] = k;
+    }
+    free(fill);
+
+    for (int k = 0; k < m; k++) {
+        if (ks.edges[k].u == ks.edges[k].v) {
+            kernel_force(&ks, lift, k);
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        kernel_push(&ks, v);
+    }
+
+    while (ks.queued_n > 0) {
+        int v = ks.queue[ks.head];
+        ks.head = (ks.head + 1) % ks.n;
+        ks.queued_n--;
+        ks.queued[v] = 0;
+        kernel_reduce(&ks, lift, v);
+    }
+
+    graph kernel = graph_constr();
+    for (int k = 0; k < m; k++) {
+        if (ks.alive[k]) {
+            edge e = edge_constr(ks.ids[ks.edges[k].u], ks.ids[ks.edges[k].v]);
+            graph_add(&kernel, &e);
+        }
+    }
+
+    free(ks.ids);
+    free(ks.edges);
+    free(ks.alive);
+    free(ks.out_off);
+    free(ks.out);
+    free(ks.in_off);
+    free(ks.in);
+    free(ks.in_deg);
+    free(ks.out_deg);
+    free(ks.queue);
+    free(ks.queued);
+
+    return kernel;
+}
+
+/**
+ * @brief This function lifts a feedback arc set of the kernel to a feedback arc set of the original graph.
+ *
+ * @details The steps are undone in reverse order, every forced edge is added and every edge of the kernel
+ * replacing a bypassed path is replaced by the first edge of the path.
+ *
+ * @param fb feedback arc set of the kernel, which is lifted in place
+ * @param steps the reduction steps, as recorded by graph_kernelize
+ * @param n number of reduction steps
+ */
+void graph_lift_solution(graph *fb, const reduction *steps, int n) {
+    for (int i = n - 1; i >= 0; i--) {
+        edge e = steps[i].e;
+        edge lifted = steps[i].lifted;
+
+        if (steps[i].type == REDUCTION_FORCE) {
+            graph_add(fb, &e);
+        } else if (graph_remove(fb, &e)) {
+            graph_add(fb, &lifted);
+        }
+    }
+}
+
 /**
  * @brief This function prints the edges of a Graph g to the specified output.
  * e.g. 0-1 1-2 0-2
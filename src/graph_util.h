@@ -33,6 +33,32 @@ typedef struct graph {
     int *vertices;
 } graph;
 
+/**
+ * types of reduction steps, recorded by graph_kernelize
+ */
+#define REDUCTION_FORCE (0)
+#define REDUCTION_BYPASS (1)
+
+/**
+ * @brief a reduction step. A forced edge e belongs to every lifted solution. A bypass replaced the path
+ * lifted.u -> lifted.v -> e.v by the edge e, a solution containing e contains lifted instead.
+ */
+typedef struct reduction {
+    int type;
+    edge e;
+    edge lifted;
+} reduction;
+
+/**
+ * @brief the reduction steps in the order they were applied, and the number of forced edges among them.
+ */
+typedef struct graph_lift {
+    int size;
+    int capacity;
+    int forced;
+    reduction *steps;
+} graph_lift;
+
 /**
  * @brief This function returns an edge from vertex u to vertex v.
  *
@@ -68,6 +94,16 @@ void graph_destr(graph *g);
  */
 void graph_add(graph *g, edge *e);
 
+/**
+ * @brief This function removes every occurrence of an edge e from a graph g.
+ * Vertices are kept, even if no edge is left at them.
+ *
+ * @param g Graph, from which edge e shall be removed
+ * @param e Edge, to be removed from graph g
+ * @return 1, if graph g contained edge e, 0 otherwise
+ */
+int graph_remove(graph *g, edge *e);
+
 /**
  * @brief This function checks if a given edge is contained in a given Graph.
  * If the edge is contained in the graph 1 is returned, otherwise 0.
@@ -78,6 +114,58 @@ void graph_add(graph *g, edge *e);
  */
 int graph_contains_edge(graph *g, edge *e);
 
+/**
+ * @brief This function reads edges from the specified input and adds them to a graph g.
+ *
+ * @details The edges are separated by whitespace, each of them written as u-v, e.g. 0-1 1-2 2-0
+ *
+ * @param g Graph, to which the edges are added
+ * @param input the input file
+ * @return 0 on success, -1 if the input contains a malformed edge
+ */
+int graph_read(graph *g, FILE *input);
+
+/**
+ * @brief This function returns an empty list of reduction steps.
+ *
+ * @details If an error occurs during memory allocation, the program terminates with EXIT_FAILURE.
+ *
+ * @return an empty lift
+ */
+graph_lift graph_lift_constr(void);
+
+/**
+ * @brief This function frees any memory that was allocated to the lift.
+ *
+ * @param lift lift to be destructed
+ */
+void graph_lift_destr(graph_lift *lift);
+
+/**
+ * @brief This function reduces a graph g to its kernel, by applying reduction rules until none applies.
+ *
+ * @details Self loops are forced. A vertex with in-degree or out-degree 0 is removed. If the only in-edge
+ * of a vertex comes from u and the vertex also has an edge to u, the in-edge is forced, since it breaks every
+ * cycle through the vertex, in particular the 2-cycle with u. Likewise for the only out-edge. A vertex with
+ * one in-edge u -> x and one out-edge x -> w is bypassed by u -> w, unless that edge already exists.
+ * Duplicate edges are removed. The applied steps are appended to lift, so a feedback arc set of the kernel
+ * is lifted to a feedback arc set of g of the same size plus the forced edges, by graph_lift_solution.
+ *
+ * @param g the graph, which is not modified
+ * @param lift the lift, where the reduction steps are appended to
+ * @return the kernel
+ */
+graph graph_kernelize(graph *g, graph_lift *lift);
+
+/**
+ * @brief This function lifts a feedback arc set of the kernel to a feedback arc set of the original graph.
+ *
+ * @param fb feedback arc set of the kernel, which is lifted in place
+ * @param steps the reduction steps, as recorded by graph_kernelize
+ * @param n number of reduction steps
+ */
+void graph_lift_solution(graph *fb, const reduction *steps, int n);
+
 /**
  * @brief This function prints the edges of a Graph g to the specified output.
  *
@@ -0,0 +1,23 @@
+/**
+ * @file namespace.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ */
+
+#include "namespace.h"
+#include <stdio.h>
+
+/**
+ * @brief This function writes the full name of a shared memory object or semaphore to buf.
+ *
+ * @param buf buffer of NAME_LEN characters
+ * @param ns the namespace, or NULL for the default names
+ * @param name the name, e.g. "shm"
+ */
+void namespace_name(char *buf, const char *ns, const char *name) {
+    if (ns == NULL) {
+        snprintf(buf, NAME_LEN, "%s%s", NAME_PREFIX, name);
+    } else {
+        snprintf(buf, NAME_LEN, "%s%s_%s", NAME_PREFIX, ns, name);
+    }
+}
@@ -0,0 +1,32 @@
+/**
+ * @file namespace.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the names of shared memory objects and semaphores, implemented by @file namespace.c
+ *
+ * @details Every shared memory object and semaphore is named NAME_PREFIX followed by its name,
+ * e.g. /11806442_shm. If a namespace is given, it is inserted after the prefix, e.g. /11806442_job42_shm,
+ * so several independent instances can run on the same host.
+ */
+
+#ifndef FB_ARC_SET_NAMESPACE_H
+#define FB_ARC_SET_NAMESPACE_H
+
+/**
+ * common prefix of all names, maximum length of a name and of a namespace
+ */
+#define NAME_PREFIX "/11806442_"
+#define NAME_LEN (64)
+#define NAMESPACE_LEN (32)
+
+/**
+ * @brief This function writes the full name of a shared memory object or semaphore to buf.
+ *
+ * @param buf buffer of NAME_LEN characters
+ * @param ns the namespace, or NULL for the default names
+ * @param name the name, e.g. "shm"
+ */
+void namespace_name(char *buf, const char *ns, const char *name);
+
+#endif //FB_ARC_SET_NAMESPACE_H
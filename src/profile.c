@@ -0,0 +1,243 @@
+/**
+ * @file profile.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The hardware counter profiling of the hot path phases, using perf_event_open(2).
+ */
+
+#include "profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/**
+ * number of counters in the group
+ */
+#define COUNTERS (4)
+
+/**
+ * the counters, the first one leads the group
+ */
+static const unsigned long long counter_config[COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+};
+
+/**
+ * names of the phases in the report
+ */
+static const char *phase_names[PROFILE_PHASES] = {"permutation", "fas", "write_copy", "read_copy", "compare"};
+
+/**
+ * @brief the measurements of a phase.
+ */
+typedef struct phase_profile {
+    unsigned long long calls;
+    unsigned long long sampled;
+    unsigned long long edges;
+    unsigned long long counts[COUNTERS];
+    unsigned long long start[COUNTERS];
+    int active;
+} phase_profile;
+
+/**
+ * set, while profiling is enabled
+ */
+static int enabled = 0;
+
+/**
+ * sampling period, name of this process, the counter group and the position of every counter in a
+ * group read, -1 if the counter is not available
+ */
+static unsigned long long period = 1;
+static const char *process_name = NULL;
+static int fds[COUNTERS] = {-1, -1, -1, -1};
+static int slot[COUNTERS] = {-1, -1, -1, -1};
+static int opened = 0;
+
+static phase_profile phases[PROFILE_PHASES];
+
+/**
+ * @brief Opens a hardware counter for user space of the calling process.
+ *
+ * @param config the counter, PERF_COUNT_HW_*
+ * @param group the group leader, or -1 to open a leader
+ * @return the file descriptor, or -1 on error
+ */
+static int open_counter(unsigned long long config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+/**
+ * @brief Reads the counter group.
+ *
+ * @param values output, the value of every counter, 0 for unavailable counters
+ * @return 0 on success, -1 on error
+ */
+static int read_counters(unsigned long long *values) {
+    unsigned long long buf[1 + COUNTERS];
+
+    if (read(fds[0], buf, sizeof(unsigned long long) * (1 + opened)) == -1) {
+        return -1;
+    }
+    for (int k = 0; k < COUNTERS; k++) {
+        values[k] = slot[k] == -1 ? 0 : buf[1 + slot[k]];
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the report of every phase to stderr, called at exit.
+ */
+static void profile_report(void) {
+    if (!enabled) {
+        return;
+    }
+
+    fprintf(stderr, "profile of %s %d, sampling every %llu. call of a phase:\n", process_name, (int) getpid(), period);
+    fprintf(stderr, "%-12s %12s %10s %14s %14s %6s %12s %12s %12s %10s %10s\n", "phase", "calls", "sampled",
+            "cycles", "instructions", "ipc", "llc_misses", "br_misses", "edges", "llc/edge", "br/edge");
+
+    for (int p = 0; p < PROFILE_PHASES; p++) {
+        phase_profile *ph = &phases[p];
+        if (ph->sampled == 0) {
+            continue;
+        }
+
+        fprintf(stderr, "%-12s %12llu %10llu %14llu", phase_names[p], ph->calls, ph->sampled, ph->counts[0]);
+        if (slot[1] != -1) {
+            fprintf(stderr, " %14llu %6.2f", ph->counts[1],
+                    ph->counts[0] > 0 ? (double) ph->counts[1] / (double) ph->counts[0] : 0.0);
+        } else {
+            fprintf(stderr, " %14s %6s", "-", "-");
+        }
+        for (int k = 2; k < COUNTERS; k++) {
+            if (slot[k] != -1) {
+                fprintf(stderr, " %12llu", ph->counts[k]);
+            } else {
+                fprintf(stderr, " %12s", "-");
+            }
+        }
+        fprintf(stderr, " %12llu", ph->edges);
+        for (int k = 2; k < COUNTERS; k++) {
+            if (slot[k] != -1 && ph->edges > 0) {
+                fprintf(stderr, " %10.4f", (double) ph->counts[k] / (double) ph->edges);
+            } else {
+                fprintf(stderr, " %10s", "-");
+            }
+        }
+        fprintf(stderr, "\n");
+    }
+}
+
+/**
+ * @brief This function enables profiling for the calling process, if FB_PROFILE is set.
+ *
+ * @details Registers the report with atexit(3). Counters are not inherited by forked children,
+ * which call profile_disable.
+ *
+ * @param name the name of the process in the report
+ */
+void profile_init(const char *name) {
+    const char *env = getenv(PROFILE_ENV);
+
+    if (env == NULL || env[0] == '\0') {
+        return;
+    }
+
+    char *endptr;
+    long n = strtol(env, &endptr, 10);
+    period = endptr[0] == '\0' && n > 0 ? (unsigned long long) n : 1;
+    process_name = name;
+
+    fds[0] = open_counter(counter_config[0], -1);
+    if (fds[0] == -1) {
+        fprintf(stderr, "profile: hardware counters not available (%s), profiling disabled\n", strerror(errno));
+        return;
+    }
+    slot[0] = opened++;
+
+    for (int k = 1; k < COUNTERS; k++) {
+        fds[k] = open_counter(counter_config[k], fds[0]);
+        if (fds[k] != -1) {
+            slot[k] = opened++;
+        }
+    }
+
+    memset(phases, 0, sizeof(phases));
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    enabled = 1;
+    atexit(profile_report);
+}
+
+/**
+ * @brief This function disables profiling, without reporting, e.g. in a forked child.
+ */
+void profile_disable(void) {
+    enabled = 0;
+    for (int k = 0; k < COUNTERS; k++) {
+        if (fds[k] != -1) {
+            close(fds[k]);
+            fds[k] = -1;
+        }
+    }
+}
+
+/**
+ * @brief This function marks the begin of a phase.
+ *
+ * @param phase the phase, one of PROFILE_PERMUTATION .. PROFILE_COMPARE
+ */
+void profile_begin(int phase) {
+    if (!enabled) {
+        return;
+    }
+
+    phase_profile *ph = &phases[phase];
+    ph->active = ph->calls++ % period == 0 && read_counters(ph->start) == 0;
+}
+
+/**
+ * @brief This function marks the end of a phase.
+ *
+ * @param phase the phase, as passed to profile_begin
+ * @param edges number of edges evaluated or copied in the phase
+ */
+void profile_end(int phase, unsigned long long edges) {
+    if (!enabled || !phases[phase].active) {
+        return;
+    }
+
+    phase_profile *ph = &phases[phase];
+    unsigned long long now[COUNTERS];
+
+    ph->active = 0;
+    if (read_counters(now) == -1) {
+        return;
+    }
+    for (int k = 0; k < COUNTERS; k++) {
+        ph->counts[k] += now[k] - ph->start[k];
+    }
+    ph->edges += edges;
+    ph->sampled++;
+}
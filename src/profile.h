@@ -0,0 +1,64 @@
+/**
+ * @file profile.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the hardware counter profiling of the hot path phases, implemented by @file profile.c
+ *
+ * @details Profiling is opt-in at runtime: if the environment variable FB_PROFILE is set to a period n,
+ * every n-th call of each phase is measured with a group of hardware counters (cycles, instructions,
+ * last level cache misses, branch misses), opened by perf_event_open(2) for user space of the calling process.
+ * At exit, the process reports IPC and misses per evaluated edge of every phase to stderr, which tells,
+ * whether a phase is bound by memory or by compute. If the counters are not available, e.g. in a container
+ * without CAP_PERFMON, a single message is printed and profiling stays disabled.
+ */
+
+#ifndef FB_ARC_SET_PROFILE_H
+#define FB_ARC_SET_PROFILE_H
+
+/**
+ * environment variable enabling profiling, and its value being the sampling period
+ */
+#define PROFILE_ENV "FB_PROFILE"
+
+/**
+ * the profiled phases
+ */
+#define PROFILE_PERMUTATION (0)
+#define PROFILE_FAS (1)
+#define PROFILE_WRITE_COPY (2)
+#define PROFILE_READ_COPY (3)
+#define PROFILE_COMPARE (4)
+#define PROFILE_PHASES (5)
+
+/**
+ * @brief This function enables profiling for the calling process, if FB_PROFILE is set.
+ *
+ * @details Registers the report with atexit(3). Counters are not inherited by forked children,
+ * which call profile_disable.
+ *
+ * @param name the name of the process in the report
+ */
+void profile_init(const char *name);
+
+/**
+ * @brief This function disables profiling, without reporting, e.g. in a forked child.
+ */
+void profile_disable(void);
+
+/**
+ * @brief This function marks the begin of a phase.
+ *
+ * @param phase the phase, one of PROFILE_PERMUTATION .. PROFILE_COMPARE
+ */
+void profile_begin(int phase);
+
+/**
+ * @brief This function marks the end of a phase.
+ *
+ * @param phase the phase, as passed to profile_begin
+ * @param edges number of edges evaluated or copied in the phase
+ */
+void profile_end(int phase, unsigned long long edges);
+
+#endif //FB_ARC_SET_PROFILE_H
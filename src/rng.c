@@ -0,0 +1,120 @@
+/**
+ * @file rng.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The counter-based random number streams, using Philox4x32-10 (Salmon et al., SC 2011).
+ */
+
+#include "rng.h"
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * multipliers and key increments (Weyl sequence) of Philox4x32
+ */
+#define PHILOX_M0 (0xD2511F53U)
+#define PHILOX_M1 (0xCD9E8D57U)
+#define PHILOX_W0 (0x9E3779B9U)
+#define PHILOX_W1 (0xBB67AE85U)
+#define PHILOX_ROUNDS (10)
+
+/**
+ * @brief Computes the Philox4x32-10 function of a counter.
+ *
+ * @param ctr the counter, replaced by the four random numbers
+ * @param key the key
+ */
+static void philox(unsigned int *ctr, const unsigned int *key) {
+    unsigned int k0 = key[0];
+    unsigned int k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        unsigned long long p0 = (unsigned long long) PHILOX_M0 * ctr[0];
+        unsigned long long p1 = (unsigned long long) PHILOX_M1 * ctr[2];
+        unsigned int c1 = ctr[1];
+        unsigned int c3 = ctr[3];
+
+        ctr[0] = (unsigned int) (p1 >> 32) ^ c1 ^ k0;
+        ctr[1] = (unsigned int) p1;
+        ctr[2] = (unsigned int) (p0 >> 32) ^ c3 ^ k1;
+        ctr[3] = (unsigned int) p0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+/**
+ * @brief This function creates the stream of a worker, positioned at the first draw of iteration 0.
+ *
+ * @param seed the seed of the run
+ * @param worker the worker, unique within the run
+ * @return the stream
+ */
+rng_stream rng_constr(unsigned long long seed, int worker) {
+    rng_stream r = {.key = {(unsigned int) seed, (unsigned int) (seed >> 32)}, .worker = (unsigned int) worker};
+    rng_seek(&r, 0);
+    return r;
+}
+
+/**
+ * @brief This function positions the stream at the first draw of an iteration.
+ *
+ * @param r the stream
+ * @param iteration the iteration
+ */
+void rng_seek(rng_stream *r, unsigned long long iteration) {
+    r->iteration = iteration;
+    r->draw = 0;
+}
+
+/**
+ * @brief This function returns the next number of the stream.
+ *
+ * @param r the stream
+ * @return a uniformly distributed 32 bit number
+ */
+unsigned int rng_next(rng_stream *r) {
+    if (r->draw % 4 == 0) {
+        r->block[0] = r->draw / 4;
+        r->block[1] = (unsigned int) r->iteration;
+        r->block[2] = (unsigned int) (r->iteration >> 32);
+        r->block[3] = r->worker;
+        philox(r->block, r->key);
+    }
+    return r->block[r->draw++ % 4];
+}
+
+/**
+ * @brief This function returns the next number of the stream, reduced to a range.
+ *
+ * @details Uses the upper bits of the product with n, which is cheaper than a division and
+ * biased by at most n / 2^32.
+ *
+ * @param r the stream
+ * @param n the size of the range, at least 1
+ * @return a number in [0, n)
+ */
+int rng_below(rng_stream *r, int n) {
+    return (int) (((unsigned long long) rng_next(r) * (unsigned int) n) >> 32);
+}
+
+/**
+ * @brief This function derives a seed from the clock and the process id, for runs without a given seed.
+ *
+ * @details The sum is mixed by the finalizer of SplitMix64, so close clocks give unrelated seeds.
+ *
+ * @return the seed
+ */
+unsigned long long rng_default_seed(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    unsigned long long z = (unsigned long long) ts.tv_sec * 1000000000ULL + (unsigned long long) ts.tv_nsec;
+    z += (unsigned long long) getpid() << 32;
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
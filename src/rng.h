@@ -0,0 +1,70 @@
+/**
+ * @file rng.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the counter-based random number streams, implemented by @file rng.c
+ *
+ * @details The numbers are the Philox4x32-10 function of a key, the seed of the run, and a counter made of
+ * the worker, the iteration and the index of the draw within the iteration. Philox is a bijection of the
+ * counter for every key, so the streams of two workers never overlap, and every draw can be computed again
+ * from (seed, worker, iteration) alone, without replaying the stream up to it.
+ */
+
+#ifndef FB_ARC_SET_RNG_H
+#define FB_ARC_SET_RNG_H
+
+/**
+ * @brief a random number stream of one worker, positioned at a draw of an iteration.
+ * block caches the four numbers of the counter (worker, iteration, draw / 4).
+ */
+typedef struct rng_stream {
+    unsigned int key[2];
+    unsigned int worker;
+    unsigned long long iteration;
+    unsigned int draw;
+    unsigned int block[4];
+} rng_stream;
+
+/**
+ * @brief This function creates the stream of a worker, positioned at the first draw of iteration 0.
+ *
+ * @param seed the seed of the run
+ * @param worker the worker, unique within the run
+ * @return the stream
+ */
+rng_stream rng_constr(unsigned long long seed, int worker);
+
+/**
+ * @brief This function positions the stream at the first draw of an iteration.
+ *
+ * @param r the stream
+ * @param iteration the iteration
+ */
+void rng_seek(rng_stream *r, unsigned long long iteration);
+
+/**
+ * @brief This function returns the next number of the stream.
+ *
+ * @param r the stream
+ * @return a uniformly distributed 32 bit number
+ */
+unsigned int rng_next(rng_stream *r);
+
+/**
+ * @brief This function returns the next number of the stream, reduced to a range.
+ *
+ * @param r the stream
+ * @param n the size of the range, at least 1
+ * @return a number in [0, n)
+ */
+int rng_below(rng_stream *r, int n);
+
+/**
+ * @brief This function derives a seed from the clock and the process id, for runs without a given seed.
+ *
+ * @return the seed
+ */
+unsigned long long rng_default_seed(void);
+
+#endif //FB_ARC_SET_RNG_H
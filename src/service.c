@@ -0,0 +1,579 @@
+/**
+ * @file service.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief A long-running solver service, accepting jobs over a unix domain socket.
+ */
+
+#include "service.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "graph_util.h"
+#include "graph_shm.h"
+#include "circular_buffer.h"
+#include "elite_pool.h"
+#include "namespace.h"
+#include "solver.h"
+#include "stats.h"
+#include "trace.h"
+
+/**
+ * @brief a token, handed to a worker through the token pipe, naming the job to work on.
+ * Its size is below PIPE_BUF, so tokens are written and read atomically.
+ */
+typedef struct job_token {
+    char ns[NAMESPACE_LEN];
+} job_token;
+
+/**
+ * @brief a job, a worker is attached to: its namespace, graph, circular buffer and elite pool,
+ * the attachments of the circular buffer and the pool and the search session of the worker on it.
+ */
+typedef struct worker_job {
+    char ns[NAMESPACE_LEN];
+    graph_shm *gs;
+    circular_buffer *cb;
+    elite_pool *pool;
+    buffer_attachment attachment;
+    pool_attachment pool_attachment;
+    solver_session session;
+} worker_job;
+
+/** set on SIGINT or SIGTERM */
+static volatile sig_atomic_t quit = 0;
+
+/**
+ * @brief signal handler to receive a SIGINT or SIGTERM signal
+ *
+ * @param signal
+ */
+static void handle_signal(int signal) {
+    quit = 1;
+}
+
+/**
+ * @brief signal handler to receive the SIGCHLD signal, only interrupting accept(2)
+ *
+ * @param signal
+ */
+static void handle_child(int signal) {
+}
+
+/**
+ * @brief Prints an error message to stderr, and terminates the program
+ * with EXIT_FAILURE.
+ *
+ * @param message to be printed
+ */
+static void error_and_exit(char *message) {
+    fprintf(stderr, "%s: %s\n", message, strerror(errno));
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief installs a signal handler, without restarting interrupted system calls.
+ *
+ * @param signal the signal
+ * @param handler the handler
+ */
+static void set_handler(int signal, void (*handler)(int)) {
+    struct sigaction sa = {.sa_handler = handler};
+    sigaction(signal, &sa, NULL);
+}
+
+/**
+ * @brief This function attaches a worker to the job named ns and starts its search session.
+ *
+ * @param job the cache entry, receiving the job
+ * @param ns the namespace of the job
+ * @return 0 on success, -1 if the job has finished in the meantime or memory could not be allocated
+ */
+static int job_open(worker_job *job, const char *ns) {
+    snprintf(job->ns, sizeof(job->ns), "%s", ns);
+
+    job->gs = graph_shm_attach(ns);
+    if (job->gs == NULL) {
+        return -1;
+    }
+    job->cb = circular_buffer_attach(ns);
+    if (job->cb == NULL) {
+        graph_shm_destr(job->gs, 0);
+        return -1;
+    }
+    circular_buffer_save(&job->attachment);
+    job->pool = elite_pool_attach(ns);
+    if (job->pool != NULL) {
+        elite_pool_save(&job->pool_attachment);
+    }
+
+    if (solver_session_constr(&job->session, job->cb, job->gs, job->pool) == -1) {
+        if (job->pool != NULL) {
+            elite_pool_destr(job->pool, 0);
+        }
+        circular_buffer_destr(job->cb, 0);
+        graph_shm_destr(job->gs, 0);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief This function ends the search session of a worker on a job and detaches from it.
+ *
+ * @param job the cache entry of the job
+ */
+static void job_close(worker_job *job) {
+    circular_buffer_restore(&job->attachment);
+    solver_session_destr(&job->session);
+    if (job->pool != NULL) {
+        elite_pool_restore(&job->pool_attachment);
+        elite_pool_destr(job->pool, 0);
+    }
+    circular_buffer_destr(job->cb, 0);
+    graph_shm_destr(job->gs, 0);
+}
+
+/**
+ * @brief This function removes the job at index i from the cache of a worker, detaching from it.
+ *
+ * @param jobs the cached jobs
+ * @param size pointer to the number of cached jobs
+ * @param i the index of the job
+ */
+static void job_evict(worker_job *jobs, int *size, int i) {
+    job_close(&jobs[i]);
+    jobs[i] = jobs[*size - 1];
+    *size -= 1;
+}
+
+/**
+ * @brief The main loop of a worker, taking tokens and searching on the named jobs for one slice each,
+ * until the token pipe is closed.
+ *
+ * @details After SERVICE_SLICE_MS milliseconds, the worker puts the token back at the end of the pipe,
+ * unless the job has terminated. So the tokens of all jobs take turns, and a new job gets workers within
+ * a slice. The worker stays attached to every job it has worked on, keyed by namespace, and keeps its
+ * search session, so the next slice on the job continues where the last one stopped, instead of attaching
+ * and starting over. Terminated jobs are detached before every slice.
+ * The write end of the pipe does not block, if the pipe is full, the token is dropped and the job keeps
+ * fewer workers.
+ * A token may name a job, which has finished in the meantime, attaching to it fails then
+ * and the token is skipped.
+ *
+ * @param tokens the token pipe
+ */
+static void worker_loop(int tokens[2]) {
+    worker_job jobs[SERVICE_MAX_JOBS];
+    int size = 0;
+
+    for (;;) {
+        job_token token;
+        ssize_t r = read(tokens[0], &token, sizeof(token));
+
+        if (r == -1 && errno == EINTR) {
+            continue;
+        }
+        if (r != sizeof(token)) {
+            _exit(EXIT_SUCCESS);
+        }
+
+        for (int i = size - 1; i >= 0; i--) {
+            if (circular_buffer_terminated(jobs[i].cb)) {
+                job_evict(jobs, &size, i);
+            }
+        }
+
+        int i = 0;
+        while (i < size && strcmp(jobs[i].ns, token.ns) != 0) {
+            i++;
+        }
+        if (i == size) {
+            if (size == SERVICE_MAX_JOBS) {
+                job_evict(jobs, &size, 0);
+                i = size;
+            }
+            if (job_open(&jobs[i], token.ns) == -1) {
+                continue;
+            }
+            size++;
+        }
+
+        worker_job *job = &jobs[i];
+        circular_buffer_restore(&job->attachment);
+        if (job->pool != NULL) {
+            elite_pool_restore(&job->pool_attachment);
+        }
+        int result = solver_resume(&job->session, job->cb, &job->gs, job->ns, job->pool,
+                                   stats_now_ns() + SERVICE_SLICE_MS * 1000000ULL);
+        int terminated = circular_buffer_terminated(job->cb);
+        TRACE_FLUSH();
+
+        if (result == -1 || terminated) {
+            job_evict(jobs, &size, i);
+        }
+        if (!terminated) {
+            while (write(tokens[1], &token, sizeof(token)) == -1 && errno == EINTR) {
+            }
+        }
+    }
+}
+
+/**
+ * @brief Starts a worker process.
+ *
+ * @details The worker keeps the write end of the token pipe open to put tokens back, so it never reads
+ * the end of the pipe. Instead it is terminated by the service, or receives SIGTERM, if the service dies.
+ *
+ * @param listen_fd the listening socket, closed by the worker
+ * @param tokens the token pipe
+ * @return the pid of the worker
+ */
+static pid_t spawn_worker(int listen_fd, int tokens[2]) {
+    pid_t service = getpid();
+    pid_t pid = fork();
+
+    if (pid == -1) {
+        error_and_exit("fork failed");
+    }
+    if (pid == 0) {
+        set_handler(SIGINT, SIG_DFL);
+        set_handler(SIGTERM, SIG_DFL);
+        set_handler(SIGCHLD, SIG_DFL);
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+        if (getppid() != service) {
+            _exit(EXIT_SUCCESS);
+        }
+        close(listen_fd);
+        TRACE_INIT("worker");
+        worker_loop(tokens);
+    }
+    return pid;
+}
+
+/**
+ * @brief Writes the response line of a job to the client.
+ *
+ * @param client the client socket
+ * @param status the status, OK, INFEASIBLE, TIMEOUT or ERROR
+ * @param best the best solution, or NULL
+ * @param elapsed_ms milliseconds since the job started
+ */
+static void respond(int client, const char *status, graph *best, long elapsed_ms) {
+    FILE *out = fdopen(dup(client), "w");
+
+    if (out == NULL) {
+        return;
+    }
+
+    if (best == NULL || best->size_e == INT_MAX) {
+        fprintf(out, "%s -1 %ld\n", status, elapsed_ms);
+    } else {
+        fprintf(out, "%s %d %ld ", status, best->size_e, elapsed_ms);
+        graph_print(best, out);
+    }
+
+    fclose(out);
+}
+
+/**
+ * @brief Reads the request of a job, consisting of the budget, the target and the edges of the graph.
+ *
+ * @param client the client socket
+ * @param budget_ms pointer to variable, which stores the budget in milliseconds
+ * @param target pointer to variable, which stores the target number of edges
+ * @param g the graph, where the edges are added to
+ * @return 0 on success, -1 on a malformed request
+ */
+static int read_request(int client, int *budget_ms, int *target, graph *g) {
+    FILE *in = fdopen(dup(client), "r");
+    char *line = NULL;
+    size_t cap = 0;
+    int off = 0;
+    int result = -1;
+
+    if (in == NULL) {
+        return -1;
+    }
+
+    if (getline(&line, &cap, in) > 0 && sscanf(line, "%d %d%n", budget_ms, target, &off) == 2
+        && *budget_ms > 0 && *target >= 0) {
+        FILE *edges = fmemopen(line + off, strlen(line + off), "r");
+        if (edges != NULL) {
+            result = graph_read(g, edges);
+            fclose(edges);
+        }
+    }
+
+    free(line);
+    fclose(in);
+    return result;
+}
+
+/**
+ * @brief Returns a lower bound of the size of every feedback arc set of the graph, gs is the kernel of.
+ *
+ * @details Every solution contains the forced edges, and at least one edge of every component of the
+ * kernel with more than one vertex, since such a component contains a cycle.
+ *
+ * @param gs the kernel
+ * @return the lower bound
+ */
+static int lower_bound(const graph_shm *gs) {
+    const int *scc_off = graph_shm_scc_off(gs);
+    int bound = gs->size_forced;
+
+    for (int c = 0; c < gs->size_scc; c++) {
+        bound += scc_off[c + 1] - scc_off[c] > 1;
+    }
+    return bound;
+}
+
+/**
+ * @brief Returns the status of a job, which ended with the best solution best.
+ *
+ * @details A solution of the size of the lower bound is optimal. So if it still exceeds the target,
+ * no budget would reach the target.
+ *
+ * @param best the size of the best solution, INT_MAX if there is none
+ * @param target the target number of edges
+ * @param bound the lower bound of the size of every solution
+ * @return OK, INFEASIBLE or TIMEOUT
+ */
+static const char *job_status(int best, int target, int bound) {
+    if (best <= target) {
+        return "OK";
+    }
+    return best == bound ? "INFEASIBLE" : "TIMEOUT";
+}
+
+/**
+ * @brief Runs a job in its own process: reads the request, publishes the kernel of the graph and the
+ * circular buffer, hands out tokens to the workers and reads solutions, until the target or the budget
+ * is reached, or the solution is optimal. A graph, which is solved by the reductions alone, is answered
+ * right away.
+ *
+ * @param client the client socket
+ * @param tokens write end of the token pipe
+ * @param share number of tokens, i.e. workers, which take turns on this job
+ * @param seed the seed of the random streams of the workers
+ */
+static void run_job(int client, int tokens, int share, unsigned long long seed) {
+    unsigned long long start = stats_now_ns();
+    int budget_ms, target;
+    graph g = graph_constr();
+
+    set_handler(SIGINT, handle_signal);
+    set_handler(SIGTERM, handle_signal);
+    set_handler(SIGCHLD, SIG_DFL);
+    TRACE_INIT("job");
+
+    if (read_request(client, &budget_ms, &target, &g) == -1) {
+        FILE *out = fdopen(client, "w");
+        if (out != NULL) {
+            fprintf(out, "ERROR malformed request\n");
+            fclose(out);
+        }
+        _exit(EXIT_FAILURE);
+    }
+
+    graph best = graph_constr();
+
+    if (g.size_e == 0) {
+        respond(client, "OK", &best, 0);
+        _exit(EXIT_SUCCESS);
+    }
+
+    char ns[NAMESPACE_LEN];
+    snprintf(ns, sizeof(ns), "job%d", (int) getpid());
+
+    graph_lift lift = graph_lift_constr();
+    graph kernel = graph_kernelize(&g, &lift);
+
+    if (kernel.size_e == 0) {
+        graph_lift_solution(&best, lift.steps, lift.size);
+        respond(client, job_status(best.size_e, target, best.size_e), &best,
+                (long) ((stats_now_ns() - start) / 1000000));
+        _exit(EXIT_SUCCESS);
+    }
+
+    graph_shm *full = graph_shm_build(&g, NULL);
+    graph_shm *gs = graph_shm_publish(&kernel, &lift, ns);
+    graph_destr(&kernel);
+    graph_lift_destr(&lift);
+    graph_destr(&g);
+
+    int bound = lower_bound(gs);
+    circular_buffer *cb = circular_buffer_setup(1, ns, seed);
+    elite_pool *pool = elite_pool_setup(ns);
+
+    job_token token;
+    memset(&token, 0, sizeof(token));
+    snprintf(token.ns, sizeof(token.ns), "%s", ns);
+    for (int i = 0; i < share; i++) {
+        if (write(tokens, &token, sizeof(token)) != sizeof(token)) {
+            break;
+        }
+    }
+
+    unsigned long long deadline = start + (unsigned long long) budget_ms * 1000000ULL;
+    best.size_e = INT_MAX;
+
+    while (!quit && stats_now_ns() < deadline && best.size_e > target && best.size_e != bound) {
+        graph fb = graph_constr();
+        if (circular_buffer_read_until(cb, &fb, NULL, deadline) == -1) {
+            graph_destr(&fb);
+            continue;
+        }
+        if (fb.size_e < best.size_e && graph_shm_is_fas(full, &fb) == 1) {
+            graph_destr(&best);
+            best = fb;
+            circular_buffer_set_bound(cb, best.size_e);
+        } else {
+            graph_destr(&fb);
+        }
+    }
+
+    circular_buffer_terminate(cb);
+
+    long elapsed_ms = (long) ((stats_now_ns() - start) / 1000000);
+    respond(client, job_status(best.size_e, target, bound), &best, elapsed_ms);
+
+    circular_buffer_destr(cb, 1);
+    elite_pool_destr(pool, 1);
+    graph_shm_destr(gs, 1);
+    free(full);
+    graph_destr(&best);
+    close(client);
+
+    TRACE_FLUSH();
+    _exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief This function runs the solver service, until it receives SIGINT or SIGTERM.
+ *
+ * @details Errors during the setup of the socket terminate the program with EXIT_FAILURE and
+ * print an error message to stderr.
+ *
+ * @param path path of the unix domain socket
+ * @param workers number of worker processes
+ * @param seed the seed of the random streams of the workers in every job
+ * @return EXIT_SUCCESS on successful termination
+ */
+int service_run(const char *path, int workers, unsigned long long seed) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        error_and_exit("invalid socket path");
+    }
+    strcpy(addr.sun_path, path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd == -1) {
+        error_and_exit("error creating socket");
+    }
+
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+        error_and_exit("error binding socket");
+    }
+    if (listen(listen_fd, SERVICE_MAX_JOBS) == -1) {
+        error_and_exit("error listening on socket");
+    }
+
+    int tokens[2];
+    if (pipe(tokens) == -1 || fcntl(tokens[1], F_SETFL, O_NONBLOCK) == -1) {
+        error_and_exit("error creating token pipe");
+    }
+
+    set_handler(SIGINT, handle_signal);
+    set_handler(SIGTERM, handle_signal);
+    set_handler(SIGCHLD, handle_child);
+    signal(SIGPIPE, SIG_IGN);
+
+    pid_t *pool = malloc(sizeof(pid_t) * workers);
+    pid_t jobs[SERVICE_MAX_JOBS];
+    int active = 0;
+
+    if (pool == NULL) {
+        error_and_exit("error allocating memory");
+    }
+    for (int i = 0; i < workers; i++) {
+        pool[i] = spawn_worker(listen_fd, tokens);
+    }
+
+    fprintf(stderr, "Listening on %s with %d workers, seed %llu\n", path, workers, seed);
+
+    while (!quit) {
+        pid_t pid;
+        while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+            for (int i = 0; i < workers; i++) {
+                if (pool[i] == pid) {
+                    pool[i] = spawn_worker(listen_fd, tokens);
+                }
+            }
+            for (int i = 0; i < active; i++) {
+                if (jobs[i] == pid) {
+                    jobs[i] = jobs[--active];
+                    break;
+                }
+            }
+        }
+
+        if (active == SERVICE_MAX_JOBS) {
+            struct timespec wait = {.tv_sec = 0, .tv_nsec = 10000000};
+            nanosleep(&wait, NULL);
+            continue;
+        }
+
+        int client = accept(listen_fd, NULL, NULL);
+        if (client == -1) {
+            continue;
+        }
+
+        pid = fork();
+        if (pid == 0) {
+            close(listen_fd);
+            close(tokens[0]);
+            free(pool);
+            run_job(client, tokens[1], workers, seed);
+        }
+        if (pid > 0) {
+            jobs[active++] = pid;
+        }
+        close(client);
+    }
+
+    for (int i = 0; i < active; i++) {
+        kill(jobs[i], SIGTERM);
+    }
+    for (int i = 0; i < workers; i++) {
+        kill(pool[i], SIGTERM);
+    }
+    while (wait(NULL) > 0 || errno == EINTR) {
+    }
+
+    close(listen_fd);
+    close(tokens[0]);
+    close(tokens[1]);
+    unlink(path);
+    free(pool);
+
+    return EXIT_SUCCESS;
+}
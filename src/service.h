@@ -0,0 +1,54 @@
+/**
+ * @file service.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the solver service, implemented by @file service.c
+ *
+ * @details The service listens on a unix domain socket and keeps a pool of worker processes running.
+ * Every connection is one job, consisting of a single request line
+ *
+ *     BUDGET_MS TARGET EDGE1 EDGE2 ...
+ *
+ * e.g. "500 0 0-1 1-2 2-0". Each job publishes its graph and circular buffer in its own namespace
+ * (job<pid>, see namespace.h), so jobs run concurrently, and hands out one token per worker.
+ * A worker takes a token, attaches to the job and searches for a slice of SERVICE_SLICE_MS milliseconds,
+ * recombining vertex orders with the other workers of the job through its elite pool (see elite_pool.h).
+ * Then it puts the token back, unless the job has terminated. The worker stays attached to the job and keeps
+ * its search session, so its next slice on the job continues the search instead of starting over. The tokens of all jobs take turns in the
+ * token pipe, so every slice splits the workers evenly among the running jobs, and a new job gets workers
+ * within a slice, even if earlier jobs have a long budget.
+ * The job is answered with a single response line
+ *
+ *     STATUS SIZE ELAPSED_MS EDGE1 EDGE2 ...
+ *
+ * where STATUS is OK, if a solution with at most TARGET edges was found, INFEASIBLE if the solution is
+ * optimal, but has more than TARGET edges, TIMEOUT if the budget expired first (SIZE is -1, if no solution
+ * was found at all) or ERROR, followed by a message. A solution is known to be optimal, if the reductions
+ * solve the graph alone, or if it has just one edge besides the forced edges in every strongly connected
+ * component of the kernel.
+ */
+
+#ifndef FB_ARC_SET_SERVICE_H
+#define FB_ARC_SET_SERVICE_H
+
+/**
+ * maximum number of concurrently running jobs, and the length of a slice of a worker in milliseconds
+ */
+#define SERVICE_MAX_JOBS (64)
+#define SERVICE_SLICE_MS (20)
+
+/**
+ * @brief This function runs the solver service, until it receives SIGINT or SIGTERM.
+ *
+ * @details Errors during the setup of the socket terminate the program with EXIT_FAILURE and
+ * print an error message to stderr.
+ *
+ * @param path path of the unix domain socket
+ * @param workers number of worker processes
+ * @param seed the seed of the random streams of the workers in every job
+ * @return EXIT_SUCCESS on successful termination
+ */
+int service_run(const char *path, int workers, unsigned long long seed);
+
+#endif //FB_ARC_SET_SERVICE_H
@@ -0,0 +1,243 @@
+/**
+ * @file service_check.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief A check of the solver service, sending overlapping jobs to a service with two workers.
+ *
+ * @details This program starts the supervisor in service mode and sends a large job with a long budget,
+ * which cannot reach its target and keeps every worker busy. A small job sent shortly after has to be
+ * answered within a few slices, not after the budget of the large job. Graphs, whose optimum is found
+ * and exceeds the target, have to be answered INFEASIBLE right away. The program exits with EXIT_FAILURE, if one
+ * of the responses does not match.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "stats.h"
+
+/**
+ * number of workers of the service, budget of the large job and its number of vertices, delay of the small
+ * job and the latency in milliseconds, within which it has to be answered
+ */
+#define CHECK_WORKERS "2"
+#define LARGE_BUDGET_MS (4000)
+#define LARGE_VERTICES (31)
+#define SMALL_DELAY_MS (300)
+#define SMALL_LATENCY_MS (500)
+
+/**
+ * the small job: the Paley tournament on 7 vertices, which the reductions do not shrink, and its optimum
+ */
+#define SMALL_JOB "2000 7 0-1 0-2 0-4 1-2 1-3 1-5 2-3 2-4 2-6 3-0 3-4 3-5 4-1 4-5 4-6 5-0 5-2 5-6 6-0 6-1 6-3\n"
+
+/**
+ * a 2-cycle, solved by the reductions with one edge, and a 4-cycle with two chords, which the reductions
+ * do not shrink and one edge solves, both above the target 0
+ */
+#define REDUCED_JOB "2000 0 0-1 1-0\n"
+#define CHORDS_JOB "2000 0 0-1 1-2 2-3 3-0 0-2 1-3\n"
+
+/** the program name */
+static const char *program_name;
+
+/**
+ * @brief Prints an error message to stderr, and terminates the program
+ * with EXIT_FAILURE.
+ *
+ * @param message to be printed
+ */
+static void error_and_exit(char *message) {
+    fprintf(stderr, "%s: %s\n", program_name, message);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Prints a usage message to stderr, and terminates the program
+ * with EXIT_FAILURE.
+ */
+static void usage(void) {
+    fprintf(stderr, "usage: %s [-p supervisor]\n", program_name);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Sleeps for the specified number of milliseconds.
+ *
+ * @param ms the milliseconds
+ */
+static void sleep_ms(int ms) {
+    struct timespec wait = {.tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000L};
+    while (nanosleep(&wait, &wait) == -1 && errno == EINTR) {
+    }
+}
+
+/**
+ * @brief Connects to the service and sends a job.
+ *
+ * @details Retries for a second, while the service is starting up.
+ *
+ * @param path path of the unix domain socket
+ * @param job the request line
+ * @return the connected socket
+ */
+static int send_job(const char *path, const char *job) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+
+    for (int i = 0; i < 100; i++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            error_and_exit("error creating socket");
+        }
+        if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0) {
+            size_t len = strlen(job);
+            if (write(fd, job, len) != (ssize_t) len) {
+                error_and_exit("error sending job");
+            }
+            return fd;
+        }
+        close(fd);
+        sleep_ms(10);
+    }
+
+    error_and_exit("cannot connect to the service");
+    return -1;
+}
+
+/**
+ * @brief Reads the response line of a job.
+ *
+ * @param fd the socket of the job, closed by this function
+ * @param status buffer of 16 characters, receiving the status
+ * @param size pointer to variable, which stores the size of the solution
+ * @param elapsed_ms pointer to variable, which stores the milliseconds reported by the service
+ */
+static void read_response(int fd, char *status, int *size, long *elapsed_ms) {
+    FILE *in = fdopen(fd, "r");
+    char *line = NULL;
+    size_t cap = 0;
+
+    if (in == NULL || getline(&line, &cap, in) <= 0
+        || sscanf(line, "%15s %d %ld", status, size, elapsed_ms) != 3) {
+        error_and_exit("malformed response");
+    }
+
+    free(line);
+    fclose(in);
+}
+
+/**
+ * @brief Writes the large job, a regular tournament, whose feedback arc sets are all larger than MAX_EDGES.
+ *
+ * @param buf buffer receiving the request line
+ * @param len size of buf
+ */
+static void large_job(char *buf, size_t len) {
+    size_t off = (size_t) snprintf(buf, len, "%d 0", LARGE_BUDGET_MS);
+
+    for (int u = 0; u < LARGE_VERTICES; u++) {
+        for (int d = 1; d <= LARGE_VERTICES / 2; d++) {
+            off += (size_t) snprintf(buf + off, len - off, " %d-%d", u, (u + d) % LARGE_VERTICES);
+        }
+    }
+    snprintf(buf + off, len - off, "\n");
+}
+
+/**
+ * @brief Checks a response against the expected status.
+ *
+ * @param name the name of the job
+ * @param status the status
+ * @param expected the expected status
+ * @param size the size of the solution
+ * @param elapsed_ms the milliseconds reported by the service
+ * @return 0 if the status matches, -1 otherwise
+ */
+static int check(const char *name, const char *status, const char *expected, int size, long elapsed_ms) {
+    int ok = strcmp(status, expected) == 0;
+    fprintf(stdout, "%-10s %-10s %3d %5ld ms %s\n", name, status, size, elapsed_ms, ok ? "ok" : "FAILED");
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief The main logic of this check program.
+ *
+ * @details [-p supervisor] is the path to the supervisor executable, ./supervisor by default.
+ *
+ * @param argc argument counter
+ * @param argv argument values
+ * @return EXIT_SUCCESS if every response matches, otherwise EXIT_FAILURE
+ */
+int main(int argc, char **argv) {
+    program_name = argv[0];
+    const char *supervisor = "./supervisor";
+
+    int option_index;
+    while ((option_index = getopt(argc, argv, "p:")) != -1) {
+        switch (option_index) {
+            case 'p':
+                supervisor = optarg;
+                break;
+            default:
+                usage();
+                break;
+        }
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/fb_service_check_%d.sock", (int) getpid());
+
+    pid_t service = fork();
+    if (service == -1) {
+        error_and_exit("fork failed");
+    }
+    if (service == 0) {
+        execl(supervisor, supervisor, "-d", path, "-j", CHECK_WORKERS, "-s", "1", (char *) NULL);
+        fprintf(stderr, "%s: cannot execute %s\n", program_name, supervisor);
+        _exit(EXIT_FAILURE);
+    }
+
+    char large[LARGE_VERTICES * LARGE_VERTICES * 16];
+    large_job(large, sizeof(large));
+
+    char status[16];
+    int size;
+    long elapsed_ms;
+    int failed = 0;
+
+    int large_fd = send_job(path, large);
+    sleep_ms(SMALL_DELAY_MS);
+
+    unsigned long long start = stats_now_ns();
+    read_response(send_job(path, SMALL_JOB), status, &size, &elapsed_ms);
+    long latency_ms = (long) ((stats_now_ns() - start) / 1000000);
+    failed |= check("small", status, "OK", size, elapsed_ms);
+    if (latency_ms > SMALL_LATENCY_MS) {
+        fprintf(stdout, "small job answered after %ld ms, more than %d ms FAILED\n", latency_ms, SMALL_LATENCY_MS);
+        failed = -1;
+    }
+
+    read_response(send_job(path, REDUCED_JOB), status, &size, &elapsed_ms);
+    failed |= check("reduced", status, "INFEASIBLE", size, elapsed_ms);
+    read_response(send_job(path, CHORDS_JOB), status, &size, &elapsed_ms);
+    failed |= check("chords", status, "INFEASIBLE", size, elapsed_ms);
+
+    read_response(large_fd, status, &size, &elapsed_ms);
+    failed |= check("large", status, "TIMEOUT", size, elapsed_ms);
+
+    kill(service, SIGTERM);
+    waitpid(service, NULL, 0);
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,562 @@
+/**
+ * @file solver.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The search for feedback arc sets, shared by the generator program and the workers of the solver service.
+ */
+
+#include "solver.h"
+#include "profile.h"
+#include "trace.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Swaps the values of two indices in an array.
+ *
+ * @param arr the array
+ * @param i first index
+ * @param j second index
+ */
+static void swap(int *arr, int i, int j) {
+    int tmp = arr[i];
+    arr[i] = arr[j];
+    arr[j] = tmp;
+}
+
+/**
+ * @brief a vertex and its sort key, used to repair an order after the graph changed.
+ */
+typedef struct keyed_vertex {
+    int key;
+    int v;
+} keyed_vertex;
+
+/**
+ * @brief compares two keyed vertices by key, used by qsort(3).
+ */
+static int compare_keyed(const void *a, const void *b) {
+    const keyed_vertex *x = a;
+    const keyed_vertex *y = b;
+    if (x->key != y->key) {
+        return (x->key > y->key) - (x->key < y->key);
+    }
+    return (x->v > y->v) - (x->v < y->v);
+}
+
+/**
+ * @brief Allocates the arrays of a search state for the graph gs.
+ *
+ * @param st the search state
+ * @param gs the graph
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+static int search_alloc(search_state *st, const graph_shm *gs) {
+    st->order = malloc(sizeof(int) * (gs->size_v + 1));
+    st->cand = malloc(sizeof(int) * (gs->size_v + 1));
+    st->pos = malloc(sizeof(int) * (gs->size_v + 1));
+    st->count = malloc(sizeof(int) * (gs->size_scc + 1));
+    st->work = malloc(sizeof(int) * (gs->size_scc + 1));
+    st->elite_a = malloc(sizeof(int) * (gs->size_v + 1));
+    st->elite_b = malloc(sizeof(int) * (gs->size_v + 1));
+
+    if (st->order == NULL || st->cand == NULL || st->pos == NULL || st->count == NULL || st->work == NULL
+        || st->elite_a == NULL || st->elite_b == NULL) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Frees the arrays of a search state.
+ *
+ * @param st the search state
+ */
+static void search_free(search_state *st) {
+    free(st->order);
+    free(st->cand);
+    free(st->pos);
+    free(st->count);
+    free(st->work);
+    free(st->elite_a);
+    free(st->elite_b);
+}
+
+/**
+ * @brief This function counts the backward edges within component c, for the order of its vertices in seg.
+ *
+ * @param gs the shared graph
+ * @param c the component
+ * @param seg the vertices of component c, in the order to be evaluated
+ * @param pos buffer receiving the positions of the vertices of seg
+ * @return the number of edges within c, pointing backwards in seg or being a self loop
+ */
+static int count_back_edges(const graph_shm *gs, int c, const int *seg, int *pos) {
+    const int *scc = graph_shm_scc(gs);
+    const int *scc_off = graph_shm_scc_off(gs);
+    const int *out_off = graph_shm_out_off(gs);
+    const edge *edges = graph_shm_edges(gs);
+    int len = scc_off[c + 1] - scc_off[c];
+    int count = 0;
+
+    for (int i = 0; i < len; i++) {
+        pos[seg[i]] = i;
+    }
+
+    for (int i = 0; i < len; i++) {
+        int u = seg[i];
+        for (int k = out_off[u]; k < out_off[u + 1]; k++) {
+            int v = edges[k].v;
+            if (scc[v] == c && pos[v] <= i) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief This function counts the backward edges of every component of the current order.
+ *
+ * @param st the search state
+ * @param gs the shared graph
+ */
+static void search_count(search_state *st, const graph_shm *gs) {
+    const int *scc_off = graph_shm_scc_off(gs);
+    const int *out_off = graph_shm_out_off(gs);
+
+    for (int c = 0; c < gs->size_scc; c++) {
+        st->count[c] = count_back_edges(gs, c, st->order + scc_off[c], st->pos);
+        st->work[c] = 0;
+        for (int i = scc_off[c]; i < scc_off[c + 1]; i++) {
+            st->work[c] += out_off[st->order[i] + 1] - out_off[st->order[i]];
+        }
+    }
+}
+
+/**
+ * @brief This function keeps the candidate order of component c, if it has less backward edges within
+ * the component than the best order so far.
+ *
+ * @param st the search state, holding the candidate in cand
+ * @param gs the shared graph
+ * @param c the component
+ * @param evaluated pointer to variable, which is increased by the number of evaluated edges
+ */
+static void search_accept(search_state *st, const graph_shm *gs, int c, unsigned long long *evaluated) {
+    const int *scc_off = graph_shm_scc_off(gs);
+    int first = scc_off[c];
+    int len = scc_off[c + 1] - first;
+
+    int count = count_back_edges(gs, c, st->cand + first, st->pos);
+    *evaluated += st->work[c];
+    if (count < st->count[c]) {
+        memcpy(st->order + first, st->cand + first, sizeof(int) * len);
+        st->count[c] = count;
+    }
+}
+
+/**
+ * @brief This function draws a random permutation of the vertices of every component and keeps it,
+ * if it has less backward edges within the component than the best order so far.
+ *
+ * @details The components stay in topological order, so edges between components never point backwards
+ * and every component can be improved independently of the others.
+ *
+ * @param st the search state
+ * @param gs the shared graph
+ * @param rng the random stream, positioned at the iteration of this step
+ * @param evaluated pointer to variable, which stores the number of evaluated edges
+ * @return the number of backward edges of the best order, i.e. the size of its feedback arc set
+ */
+static int search_step(search_state *st, const graph_shm *gs, rng_stream *rng, unsigned long long *evaluated) {
+    const int *scc_off = graph_shm_scc_off(gs);
+    int total = 0;
+
+    *evaluated = 0;
+
+    for (int c = 0; c < gs->size_scc; c++) {
+        int first = scc_off[c];
+        int last = scc_off[c + 1] - 1;
+
+        if (last > first && st->count[c] > 0) {
+            memcpy(st->cand + first, st->order + first, sizeof(int) * (last - first + 1));
+            for (int i = last; i > first; --i) {
+                int j = first + rng_below(rng, i - first + 1);
+                swap(st->cand, i, j);
+            }
+            search_accept(st, gs, c, evaluated);
+        }
+
+        total += st->count[c];
+    }
+
+    return total;
+}
+
+/**
+ * @brief This function recombines the two elites in elite_a and elite_b, and keeps the components of
+ * the first elite and of the offspring, which have less backward edges than the best order so far.
+ *
+ * @details The offspring of every component is produced by order crossover: a random slice is copied from
+ * the first elite, the remaining positions are filled with the other vertices in the order of the second
+ * elite. Then two of its vertices are swapped, with probability 1/2. Both elites are orders of the same graph,
+ * so every component holds the same vertices in both of them.
+ *
+ * @param st the search state, holding the elites
+ * @param gs the shared graph
+ * @param rng the random stream, positioned at the iteration of this step
+ * @param evaluated pointer to variable, which stores the number of evaluated edges
+ * @return the number of backward edges of the best order, i.e. the size of its feedback arc set
+ */
+static int search_recombine(search_state *st, const graph_shm *gs, rng_stream *rng, unsigned long long *evaluated) {
+    const int *scc_off = graph_shm_scc_off(gs);
+    const int *a = st->elite_a;
+    const int *b = st->elite_b;
+    int total = 0;
+
+    *evaluated = 0;
+
+    for (int c = 0; c < gs->size_scc; c++) {
+        int first = scc_off[c];
+        int last = scc_off[c + 1] - 1;
+        int len = last - first + 1;
+
+        if (last > first && st->count[c] > 0) {
+            memcpy(st->cand + first, a + first, sizeof(int) * len);
+            search_accept(st, gs, c, evaluated);
+
+            int i = first + rng_below(rng, len);
+            int j = first + rng_below(rng, len);
+            if (i > j) {
+                int tmp = i;
+                i = j;
+                j = tmp;
+            }
+
+            for (int k = first; k <= last; k++) {
+                st->pos[b[k]] = 0;
+            }
+            for (int k = i; k <= j; k++) {
+                st->cand[k] = a[k];
+                st->pos[a[k]] = 1;
+            }
+            for (int k = first, out = first; k <= last; k++) {
+                if (st->pos[b[k]] == 0) {
+                    if (out == i) {
+                        out = j + 1;
+                    }
+                    st->cand[out++] = b[k];
+                }
+            }
+
+            if (rng_below(rng, 2) == 0) {
+                swap(st->cand, first + rng_below(rng, len), first + rng_below(rng, len));
+            }
+            search_accept(st, gs, c, evaluated);
+        }
+
+        total += st->count[c];
+    }
+
+    return total;
+}
+
+/**
+ * @brief This function carries the best order over to a new generation of the graph.
+ *
+ * @details The vertices of every new component are ordered by their position in the old order, vertices
+ * which are new to the graph go last. Removing edges therefore never makes the order worse, and
+ * components not affected by a change keep exactly their old order.
+ *
+ * @param st the search state of the new generation, receiving the repaired order
+ * @param gs the new generation
+ * @param old the search state of the old generation
+ * @param old_gs the old generation
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+static int search_repair(search_state *st, const graph_shm *gs, search_state *old, const graph_shm *old_gs) {
+    const int *ids = graph_shm_ids(gs);
+    const int *order = graph_shm_order(gs);
+    const int *scc_off = graph_shm_scc_off(gs);
+    keyed_vertex *keyed = malloc(sizeof(keyed_vertex) * (gs->size_v + 1));
+
+    if (keyed == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < old_gs->size_v; i++) {
+        old->pos[old->order[i]] = i;
+    }
+
+    for (int i = 0; i < gs->size_v; i++) {
+        int v = graph_shm_find(old_gs, ids[order[i]]);
+        keyed[i].key = v == -1 ? INT_MAX : old->pos[v];
+        keyed[i].v = order[i];
+    }
+
+    for (int c = 0; c < gs->size_scc; c++) {
+        qsort(keyed + scc_off[c], scc_off[c + 1] - scc_off[c], sizeof(keyed_vertex), compare_keyed);
+    }
+
+    for (int i = 0; i < gs->size_v; i++) {
+        st->order[i] = keyed[i].v;
+    }
+
+    free(keyed);
+    search_count(st, gs);
+    return 0;
+}
+
+/**
+ * @brief This function attaches to the newest generation of the published graph.
+ *
+ * @details Retries, until the graph can be attached or the server terminates the circular buffer.
+ *
+ * @param cb the circular buffer
+ * @param ns the namespace of the graph
+ * @return the newest generation, or NULL if the circular buffer was terminated
+ */
+static graph_shm *reattach(circular_buffer *cb, const char *ns) {
+    struct timespec wait = {.tv_sec = 0, .tv_nsec = 1000000};
+
+    while (!circular_buffer_terminated(cb)) {
+        graph_shm *gs = graph_shm_attach(ns);
+        if (gs != NULL) {
+            return gs;
+        }
+        nanosleep(&wait, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Calculates a solution for the feedback arc set problem and adds it to a feedback arc graph
+ *
+ * @details Every edge pointing backwards in the vertex order, or being a self loop, is part of the
+ * feedback arc set. Stops early, as soon as the feedback arc set exceeds MAX_EDGES, since
+ * such a solution is not written to the circular buffer anyway.
+ *
+ * @param fb feedback arc graph, where edges are added to, in original ids
+ * @param gs graph from which vertices and edges are read
+ * @param order the vertex order
+ * @param pos buffer of size_v integers, receiving the position of every vertex in order
+ */
+static void add_fb_set_to_graph(graph *fb, const graph_shm *gs, const int *order, int *pos) {
+    const int *ids = graph_shm_ids(gs);
+    const edge *edges = graph_shm_edges(gs);
+
+    for (int i = 0; i < gs->size_v; i++) {
+        pos[order[i]] = i;
+    }
+
+    for (int k = 0; k < gs->size_e && fb->size_e <= MAX_EDGES; k++) {
+        if (pos[edges[k].u] >= pos[edges[k].v]) {
+            edge e = edge_constr(ids[edges[k].u], ids[edges[k].v]);
+            graph_add(fb, &e);
+        }
+    }
+}
+
+/**
+ * @brief This function starts a search session on a graph, positioned at the first iteration of the random
+ * stream of the calling worker.
+ *
+ * @param session the session
+ * @param cb the circular buffer, the caller is attached to
+ * @param gs the graph
+ * @param pool the elite pool, or NULL to search alone
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+int solver_session_constr(solver_session *session, circular_buffer *cb, const graph_shm *gs, elite_pool *pool) {
+    if (search_alloc(&session->st, gs) == -1) {
+        search_free(&session->st);
+        return -1;
+    }
+    memcpy(session->st.order, graph_shm_order(gs), sizeof(int) * gs->size_v);
+    search_count(&session->st, gs);
+
+    session->stats = circular_buffer_stats(cb);
+    session->worker = circular_buffer_worker(cb);
+    session->rng = rng_constr(circular_buffer_seed(cb), session->worker);
+    session->iteration = 0;
+    session->written = INT_MAX;
+    session->key = pool != NULL ? elite_pool_key(gs) : 0;
+    session->offered = INT_MAX;
+
+    return 0;
+}
+
+/**
+ * @brief This function frees the search state of a session.
+ *
+ * @param session the session
+ */
+void solver_session_destr(solver_session *session) {
+    search_free(&session->st);
+}
+
+/**
+ * @brief This function continues the search of a session, writing every improvement, which does not
+ * exceed MAX_EDGES and is smaller than the bound of the server, to the circular buffer, until the server
+ * terminates the circular buffer or the deadline is reached.
+ *
+ * @details If a newer generation of the graph is published, the solver attaches to it and carries its
+ * best order over, so only the components affected by the change have to be searched again.
+ * If the graph is a kernel, solutions are lifted to the original graph before they are written.
+ * *gs is replaced by the newest generation, which has to be destructed by the caller.
+ * With an elite pool, the solver runs in recombination mode: every improved order is offered to the pool,
+ * and every SOLVER_RECOMBINE_EVERY-th iteration recombines two elites instead of shuffling. Solutions of
+ * recombination mode depend on the other generators, so they cannot be replayed by solver_replay.
+ * The session keeps its order and iteration, so a later call continues where this one stopped.
+ *
+ * @param session the session, started on *gs
+ * @param cb the circular buffer
+ * @param gs pointer to the graph
+ * @param ns the namespace of the published graph, or NULL for the default name
+ * @param pool the elite pool, or NULL to search alone
+ * @param deadline_ns the time (see stats_now_ns), at which the solver returns even without termination,
+ * or 0 to search until termination
+ * @return 0 on termination or at the deadline, -1 if memory could not be allocated
+ */
+int solver_resume(solver_session *session, circular_buffer *cb, graph_shm **gs, const char *ns, elite_pool *pool,
+                  unsigned long long deadline_ns) {
+    search_state *st = &session->st;
+    producer_stats *stats = session->stats;
+
+    while (!circular_buffer_terminated(cb) && (deadline_ns == 0 || stats_now_ns() < deadline_ns)) {
+        if (graph_shm_stale(*gs)) {
+            graph_shm *next = reattach(cb, ns);
+            if (next == NULL) {
+                break;
+            }
+
+            search_state repaired;
+            if (search_alloc(&repaired, next) == -1 || search_repair(&repaired, next, st, *gs) == -1) {
+                search_free(&repaired);
+                graph_shm_destr(next, 0);
+                return -1;
+            }
+
+            search_free(st);
+            graph_shm_destr(*gs, 0);
+            *st = repaired;
+            *gs = next;
+            session->written = INT_MAX;
+            session->key = pool != NULL ? elite_pool_key(*gs) : 0;
+            session->offered = INT_MAX;
+        }
+
+        unsigned long long evaluated;
+        TRACE_BEGIN(step);
+        profile_begin(PROFILE_PERMUTATION);
+        rng_seek(&session->rng, session->iteration);
+        int found;
+        if (pool != NULL && session->iteration % SOLVER_RECOMBINE_EVERY == SOLVER_RECOMBINE_EVERY - 1
+            && elite_pool_pick(pool, *gs, session->key, &session->rng, st->elite_a, st->elite_b) == 0) {
+            found = search_recombine(st, *gs, &session->rng, &evaluated);
+        } else {
+            found = search_step(st, *gs, &session->rng, &evaluated);
+        }
+        int total = found + (*gs)->size_forced;
+        profile_end(PROFILE_PERMUTATION, evaluated);
+        TRACE_END(step, "permutation");
+        stats_add(stats != NULL ? &stats->generated : NULL, 1);
+
+        if (pool != NULL && found < session->offered) {
+            elite_pool_offer(pool, *gs, session->key, st->order, found, session->worker);
+            session->offered = found;
+        }
+
+        if (total > MAX_EDGES) {
+            stats_add(stats != NULL ? &stats->dropped : NULL, 1);
+        } else if (total < session->written && total < circular_buffer_bound(cb)) {
+            TRACE_BEGIN(fas);
+            profile_begin(PROFILE_FAS);
+            graph fb_arc_set = graph_constr();
+            add_fb_set_to_graph(&fb_arc_set, *gs, st->order, st->pos);
+            graph_lift_solution(&fb_arc_set, graph_shm_lift(*gs), (*gs)->size_lift);
+            profile_end(PROFILE_FAS, (unsigned long long) (*gs)->size_e);
+            TRACE_END(fas, "fas");
+            circular_buffer_write(cb, &fb_arc_set, session->iteration);
+            graph_destr(&fb_arc_set);
+            session->written = total;
+        }
+        session->iteration++;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief This function searches feedback arc sets of a graph and writes every improvement, which does not
+ * exceed MAX_EDGES and is smaller than the bound of the server, to the circular buffer, until the server
+ * terminates the circular buffer or the deadline is reached.
+ *
+ * @details Runs a session from the first iteration, see solver_resume.
+ * *gs is replaced by the newest generation, which has to be destructed by the caller.
+ *
+ * @param cb the circular buffer
+ * @param gs pointer to the graph
+ * @param ns the namespace of the published graph, or NULL for the default name
+ * @param pool the elite pool, or NULL to search alone
+ * @param deadline_ns the time (see stats_now_ns), at which the solver returns even without termination,
+ * or 0 to search until termination
+ * @return 0 on termination or at the deadline, -1 if memory could not be allocated
+ */
+int solver_run(circular_buffer *cb, graph_shm **gs, const char *ns, elite_pool *pool,
+               unsigned long long deadline_ns) {
+    solver_session session;
+
+    if (solver_session_constr(&session, cb, *gs, pool) == -1) {
+        return -1;
+    }
+
+    int result = solver_resume(&session, cb, gs, ns, pool, deadline_ns);
+    solver_session_destr(&session);
+    return result;
+}
+
+/**
+ * @brief This function repeats the search of a worker up to an iteration and returns the feedback arc set,
+ * a solver with this seed and worker id would have written after that iteration.
+ *
+ * @details The search is deterministic for a given graph, seed and worker, so the result equals the
+ * solution written by the original run, as long as the graph was not changed during the run.
+ *
+ * @param gs the graph
+ * @param seed the seed of the run
+ * @param worker the worker id
+ * @param iteration the iteration
+ * @param fb feedback arc graph, where the edges of the lifted feedback arc set are added to
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+int solver_replay(const graph_shm *gs, unsigned long long seed, int worker, unsigned long long iteration,
+                  graph *fb) {
+    search_state st;
+
+    if (search_alloc(&st, gs) == -1) {
+        search_free(&st);
+        return -1;
+    }
+    memcpy(st.order, graph_shm_order(gs), sizeof(int) * gs->size_v);
+    search_count(&st, gs);
+
+    rng_stream rng = rng_constr(seed, worker);
+    unsigned long long evaluated;
+
+    for (unsigned long long i = 0; i <= iteration; i++) {
+        rng_seek(&rng, i);
+        search_step(&st, gs, &rng, &evaluated);
+    }
+
+    add_fb_set_to_graph(fb, gs, st.order, st.pos);
+    graph_lift_solution(fb, graph_shm_lift(gs), gs->size_lift);
+
+    search_free(&st);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file solver.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the feedback arc set search, implemented by @file solver.c
+ *
+ * @details A vertex order is drawn at random, every edge pointing backwards in this order is part of
+ * the feedback arc set. The strongly connected components are kept in topological order,
+ * only the vertices within a component are shuffled, and the best order of every component is kept.
+ * The shuffles of every iteration are drawn from the random stream of the worker (see rng.h), so a run
+ * is determined by the graph, the seed and the worker id, and every solution can be replayed.
+ */
+
+#ifndef FB_ARC_SET_SOLVER_H
+#define FB_ARC_SET_SOLVER_H
+
+#include "circular_buffer.h"
+#include "elite_pool.h"
+#include "graph_shm.h"
+#include "rng.h"
+
+/**
+ * in recombination mode, every SOLVER_RECOMBINE_EVERY-th iteration recombines two elites of the pool
+ */
+#define SOLVER_RECOMBINE_EVERY (4)
+
+/**
+ * @brief the state of the search on one generation of the graph.
+ * order is the best vertex order found so far, grouped by component as in graph_shm_order,
+ * count the number of backward edges within every component of order, work the number of edges
+ * evaluated per permutation of every component, cand a scratch order and pos the positions of the vertices.
+ * elite_a and elite_b receive the parents drawn from the elite pool.
+ */
+typedef struct search_state {
+    int *order;
+    int *cand;
+    int *pos;
+    int *count;
+    int *work;
+    int *elite_a;
+    int *elite_b;
+} search_state;
+
+/**
+ * @brief a search, which can be continued across several calls of solver_resume.
+ * stats and worker are the stats block and worker id of the caller in the circular buffer, rng its random
+ * stream and iteration the next iteration. written is the size of the last solution written, key the key of
+ * the graph in the elite pool and offered the size of the last order offered to it.
+ */
+typedef struct solver_session {
+    search_state st;
+    producer_stats *stats;
+    int worker;
+    rng_stream rng;
+    unsigned long long iteration;
+    int written;
+    unsigned long long key;
+    int offered;
+} solver_session;
+
+/**
+ * @brief This function starts a search session on a graph, positioned at the first iteration of the random
+ * stream of the calling worker.
+ *
+ * @param session the session
+ * @param cb the circular buffer, the caller is attached to
+ * @param gs the graph
+ * @param pool the elite pool, or NULL to search alone
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+int solver_session_constr(solver_session *session, circular_buffer *cb, const graph_shm *gs, elite_pool *pool);
+
+/**
+ * @brief This function frees the search state of a session.
+ *
+ * @param session the session
+ */
+void solver_session_destr(solver_session *session);
+
+/**
+ * @brief This function continues the search of a session, writing every improvement, which does not
+ * exceed MAX_EDGES and is smaller than the bound of the server, to the circular buffer, until the server
+ * terminates the circular buffer or the deadline is reached.
+ *
+ * @details If a newer generation of the graph is published, the solver attaches to it and carries its
+ * best order over, so only the components affected by the change have to be searched again.
+ * If the graph is a kernel, solutions are lifted to the original graph before they are written.
+ * *gs is replaced by the newest generation, which has to be destructed by the caller.
+ * With an elite pool, the solver runs in recombination mode: every improved order is offered to the pool,
+ * and every SOLVER_RECOMBINE_EVERY-th iteration recombines two elites instead of shuffling. Solutions of
+ * recombination mode depend on the other generators, so they cannot be replayed by solver_replay.
+ * The session keeps its order and iteration, so a later call continues where this one stopped.
+ *
+ * @param session the session, started on *gs
+ * @param cb the circular buffer
+ * @param gs pointer to the graph
+ * @param ns the namespace of the published graph, or NULL for the default name
+ * @param pool the elite pool, or NULL to search alone
+ * @param deadline_ns the time (see stats_now_ns), at which the solver returns even without termination,
+ * or 0 to search until termination
+ * @return 0 on termination or at the deadline, -1 if memory could not be allocated
+ */
+int solver_resume(solver_session *session, circular_buffer *cb, graph_shm **gs, const char *ns, elite_pool *pool,
+                  unsigned long long deadline_ns);
+
+/**
+ * @brief This function searches feedback arc sets of a graph and writes every improvement, which does not
+ * exceed MAX_EDGES and is smaller than the bound of the server, to the circular buffer, until the server
+ * terminates the circular buffer or the deadline is reached.
+ *
+ * @details Runs a session from the first iteration, see solver_resume.
+ * *gs is replaced by the newest generation, which has to be destructed by the caller.
+ *
+ * @param cb the circular buffer
+ * @param gs pointer to the graph
+ * @param ns the namespace of the published graph, or NULL for the default name
+ * @param pool the elite pool, or NULL to search alone
+ * @param deadline_ns the time (see stats_now_ns), at which the solver returns even without termination,
+ * or 0 to search until termination
+ * @return 0 on termination or at the deadline, -1 if memory could not be allocated
+ */
+int solver_run(circular_buffer *cb, graph_shm **gs, const char *ns, elite_pool *pool,
+               unsigned long long deadline_ns);
+
+/**
+ * @brief This function repeats the search of a worker up to an iteration and returns the feedback arc set,
+ * a solver with this seed and worker id would have written after that iteration.
+ *
+ * @details The search is deterministic for a given graph, seed and worker, so the result equals the
+ * solution written by the original run, as long as the graph was not changed during the run.
+ *
+ * @param gs the graph
+ * @param seed the seed of the run
+ * @param worker the worker id
+ * @param iteration the iteration
+ * @param fb feedback arc graph, where the edges of the lifted feedback arc set are added to
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+int solver_replay(const graph_shm *gs, unsigned long long seed, int worker, unsigned long long iteration,
+                  graph *fb);
+
+#endif //FB_ARC_SET_SOLVER_H
@@ -0,0 +1,214 @@
+/**
+ * @file stats.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief Performance counters for the generators and the circular buffer.
+ */
+
+#include "stats.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief This function returns the current value of the monotonic clock in nanoseconds.
+ *
+ * @return monotonic time in nanoseconds
+ */
+unsigned long long stats_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL + (unsigned long long) ts.tv_nsec;
+}
+
+/**
+ * @brief This function adds a value to a counter, using a relaxed atomic operation.
+ *
+ * @details Does nothing, if counter is NULL, so callers without a stats block do not need to check.
+ *
+ * @param counter the counter to be incremented
+ * @param value the value to be added
+ */
+void stats_add(unsigned long long *counter, unsigned long long value) {
+    if (counter != NULL) {
+        __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief This function loads a counter, using a relaxed atomic operation.
+ *
+ * @param counter the counter to be loaded
+ * @return the value of the counter
+ */
+static unsigned long long stats_load(unsigned long long *counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief This function writes the HELP and TYPE lines of a metric.
+ *
+ * @param output the output file
+ * @param name name of the metric
+ * @param type prometheus type of the metric, e.g. counter or gauge
+ * @param help description of the metric
+ */
+static void stats_header(FILE *output, const char *name, const char *type, const char *help) {
+    fprintf(output, "# HELP %s %s\n", name, help);
+    fprintf(output, "# TYPE %s %s\n", name, type);
+}
+
+/**
+ * @brief This function writes one counter of every active producer, labeled with the producers pid.
+ *
+ * @param output the output file
+ * @param ps array of producer stats blocks
+ * @param n number of blocks in ps
+ * @param name name of the metric
+ * @param offset offset of the counter within producer_stats
+ * @param scale divisor applied to the counter, e.g. 1e9 to convert nanoseconds to seconds
+ */
+static void stats_producer_counter(FILE *output, producer_stats *ps, int n, const char *name, size_t offset,
+                                   double scale) {
+    for (int i = 0; i < n; i++) {
+        if (__atomic_load_n(&ps[i].active, __ATOMIC_RELAXED) == 0) {
+            continue;
+        }
+        unsigned long long *counter = (unsigned long long *) ((char *) &ps[i] + offset);
+        if (scale == 1.0) {
+            fprintf(output, "%s{pid=\"%d\"} %llu\n", name, ps[i].pid, stats_load(counter));
+        } else {
+            fprintf(output, "%s{pid=\"%d\"} %.9f\n", name, ps[i].pid, (double) stats_load(counter) / scale);
+        }
+    }
+}
+
+/**
+ * @brief This function writes the rate of one counter of every active producer, per second since it started.
+ *
+ * @param output the output file
+ * @param ps array of producer stats blocks
+ * @param n number of blocks in ps
+ * @param name name of the metric
+ * @param offset offset of the counter within producer_stats
+ * @param now the current time in nanoseconds
+ */
+static void stats_producer_rate(FILE *output, producer_stats *ps, int n, const char *name, size_t offset,
+                                unsigned long long now) {
+    for (int i = 0; i < n; i++) {
+        if (__atomic_load_n(&ps[i].active, __ATOMIC_RELAXED) == 0) {
+            continue;
+        }
+        unsigned long long *counter = (unsigned long long *) ((char *) &ps[i] + offset);
+        double elapsed = (double) (now - ps[i].started_ns) / 1e9;
+        double rate = elapsed > 0 ? (double) stats_load(counter) / elapsed : 0;
+        fprintf(output, "%s{pid=\"%d\"} %.3f\n", name, ps[i].pid, rate);
+    }
+}
+
+/**
+ * @brief This function writes the producer stats and the ring snapshot in the Prometheus text exposition format.
+ *
+ * @details Generators only write solutions, which improve on their last one and the bound of the supervisor.
+ * So written solutions and solutions read by the supervisor count improvements, the throughput of
+ * the generators are the evaluated candidates.
+ *
+ * @param output the output file
+ * @param ps array of producer stats blocks
+ * @param n number of blocks in ps
+ * @param rs snapshot of the ring
+ */
+void stats_write(FILE *output, producer_stats *ps, int n, ring_stats *rs) {
+    unsigned long long now = stats_now_ns();
+
+    stats_header(output, "fb_ring_capacity", "gauge", "Number of slots in the circular buffer.");
+    fprintf(output, "fb_ring_capacity %d\n", rs->capacity);
+    stats_header(output, "fb_ring_fill", "gauge", "Number of solutions waiting in the circular buffer.");
+    fprintf(output, "fb_ring_fill %d\n", rs->fill);
+    stats_header(output, "fb_ring_producers", "gauge", "Number of attached generators, which own a stats block.");
+    fprintf(output, "fb_ring_producers %d\n", rs->producers);
+    stats_header(output, "fb_supervisor_read_total", "counter", "Improved solutions read by the supervisor.");
+    fprintf(output, "fb_supervisor_read_total %llu\n", rs->read);
+    stats_header(output, "fb_supervisor_improved_total", "counter", "Solutions, which improved the best solution.");
+    fprintf(output, "fb_supervisor_improved_total %llu\n", rs->improved);
+    stats_header(output, "fb_best_edges", "gauge", "Number of edges in the best solution, -1 if there is none.");
+    fprintf(output, "fb_best_edges %d\n", rs->best);
+    stats_header(output, "fb_pool_elites", "gauge", "Vertex orders in the elite pool.");
+    fprintf(output, "fb_pool_elites %d\n", rs->pool_elites);
+    stats_header(output, "fb_pool_best_backward_edges", "gauge",
+                 "Backward edges of the best order in the elite pool, -1 if the pool is empty.");
+    fprintf(output, "fb_pool_best_backward_edges %d\n", rs->pool_best);
+    stats_header(output, "fb_pool_offered_total", "counter", "Vertex orders offered to the elite pool.");
+    fprintf(output, "fb_pool_offered_total %llu\n", rs->pool_offered);
+    stats_header(output, "fb_pool_accepted_total", "counter", "Vertex orders accepted by the elite pool.");
+    fprintf(output, "fb_pool_accepted_total %llu\n", rs->pool_accepted);
+    stats_header(output, "fb_pool_oversized_total", "counter",
+                 "Vertex orders not pooled, since the graph exceeds the maximum number of vertices.");
+    fprintf(output, "fb_pool_oversized_total %llu\n", rs->pool_oversized);
+
+    stats_header(output, "fb_generator_generated_total", "counter", "Candidate solutions evaluated.");
+    stats_producer_counter(output, ps, n, "fb_generator_generated_total", offsetof(producer_stats, generated), 1.0);
+    stats_header(output, "fb_generator_written_total", "counter",
+                 "Improved solutions written to the circular buffer, smaller than the last one and the bound.");
+    stats_producer_counter(output, ps, n, "fb_generator_written_total", offsetof(producer_stats, written), 1.0);
+    stats_header(output, "fb_generator_dropped_total", "counter", "Candidate solutions dropped for exceeding MAX_EDGES.");
+    stats_producer_counter(output, ps, n, "fb_generator_dropped_total", offsetof(producer_stats, dropped), 1.0);
+    stats_header(output, "fb_generator_wait_free_seconds_total", "counter", "Time spent blocked on sem_free.");
+    stats_producer_counter(output, ps, n, "fb_generator_wait_free_seconds_total",
+                           offsetof(producer_stats, wait_free_ns), 1e9);
+    stats_header(output, "fb_generator_wait_mutex_seconds_total", "counter", "Time spent blocked on sem_mutex.");
+    stats_producer_counter(output, ps, n, "fb_generator_wait_mutex_seconds_total",
+                           offsetof(producer_stats, wait_mutex_ns), 1e9);
+
+    stats_header(output, "fb_generator_generated_per_second", "gauge",
+                 "Candidate solutions evaluated per second since the generator started.");
+    stats_producer_rate(output, ps, n, "fb_generator_generated_per_second",
+                        offsetof(producer_stats, generated), now);
+    stats_header(output, "fb_generator_improvements_per_second", "gauge",
+                 "Improved solutions written per second since the generator started.");
+    stats_producer_rate(output, ps, n, "fb_generator_improvements_per_second",
+                        offsetof(producer_stats, written), now);
+}
+
+/**
+ * @brief This function writes the stats to the file at path, replacing it atomically.
+ *
+ * @details The stats are written to a temporary file first, which is then renamed to path,
+ * so a scraper never reads a partially written file.
+ *
+ * @param path path of the metrics file
+ * @param ps array of producer stats blocks
+ * @param n number of blocks in ps
+ * @param rs snapshot of the ring
+ * @return 0 on success, -1 on error
+ */
+int stats_dump(const char *path, producer_stats *ps, int n, ring_stats *rs) {
+    size_t len = strlen(path);
+    char *tmp = malloc(len + 5);
+
+    if (tmp == NULL) {
+        return -1;
+    }
+
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".tmp", 5);
+
+    FILE *output = fopen(tmp, "w");
+    if (output == NULL) {
+        free(tmp);
+        return -1;
+    }
+
+    stats_write(output, ps, n, rs);
+
+    if (fclose(output) == EOF || rename(tmp, path) == -1) {
+        remove(tmp);
+        free(tmp);
+        return -1;
+    }
+
+    free(tmp);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file stats.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the performance counters, implemented by @file stats.c
+ *
+ * @details Every generator owns one producer_stats block inside the shared circular buffer and updates
+ * it with relaxed atomic operations on its hot path. The supervisor takes a snapshot of all blocks and
+ * writes them in the Prometheus text exposition format.
+ */
+
+#ifndef FB_ARC_SET_STATS_H
+#define FB_ARC_SET_STATS_H
+
+#include <stdio.h>
+
+/**
+ * maximum number of generators attached at the same time, which get their own stats block
+ */
+#define MAX_PRODUCERS (32)
+
+/**
+ * size of a cache line, blocks in shared memory written by different processes are aligned to it
+ */
+#define CACHE_LINE (64)
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE)))
+
+/**
+ * @brief per generator counters, padded to the size of one cache line (64 bytes),
+ * so generators do not false share their counters.
+ * generated counts the evaluated candidates, written only the improvements written to the circular buffer.
+ */
+typedef struct producer_stats {
+    int pid;
+    int active;
+    unsigned long long started_ns;
+    unsigned long long generated;
+    unsigned long long written;
+    unsigned long long dropped;
+    unsigned long long wait_free_ns;
+    unsigned long long wait_mutex_ns;
+    unsigned long long reserved;
+} producer_stats;
+
+/**
+ * @brief a snapshot of the ring and the supervisor side, passed to stats_write.
+ */
+typedef struct ring_stats {
+    int capacity;
+    int fill;
+    int producers;
+    unsigned long long read;
+    unsigned long long improved;
+    int best;
+    int pool_elites;
+    int pool_best;
+    unsigned long long pool_offered;
+    unsigned long long pool_accepted;
+    unsigned long long pool_oversized;
+} ring_stats;
+
+/**
+ * @brief This function returns the current value of the monotonic clock in nanoseconds.
+ *
+ * @return monotonic time in nanoseconds
+ */
+unsigned long long stats_now_ns(void);
+
+/**
+ * @brief This function adds a value to a counter, using a relaxed atomic operation.
+ *
+ * @details Does nothing, if counter is NULL, so callers without a stats block do not need to check.
+ *
+ * @param counter the counter to be incremented
+ * @param value the value to be added
+ */
+void stats_add(unsigned long long *counter, unsigned long long value);
+
+/**
+ * @brief This function writes the producer stats and the ring snapshot in the Prometheus text exposition format.
+ *
+ * @details Generators only write solutions, which improve on their last one and the bound of the supervisor.
+ * So written solutions and solutions read by the supervisor count improvements, the throughput of
+ * the generators are the evaluated candidates.
+ *
+ * @param output the output file
+ * @param ps array of producer stats blocks
+ * @param n number of blocks in ps
+ * @param rs snapshot of the ring
+ */
+void stats_write(FILE *output, producer_stats *ps, int n, ring_stats *rs);
+
+/**
+ * @brief This function writes the stats to the file at path, replacing it atomically.
+ *
+ * @details The stats are written to a temporary file first, which is then renamed to path,
+ * so a scraper never reads a partially written file.
+ *
+ * @param path path of the metrics file
+ * @param ps array of producer stats blocks
+ * @param n number of blocks in ps
+ * @param rs snapshot of the ring
+ * @return 0 on success, -1 on error
+ */
+int stats_dump(const char *path, producer_stats *ps, int n, ring_stats *rs);
+
+#endif //FB_ARC_SET_STATS_H
@@ -7,18 +7,66 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <signal.h>
+#include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include "graph_util.h"
 #include "circular_buffer.h"
+#include "elite_pool.h"
+#include "graph_shm.h"
+#include "service.h"
+#include "profile.h"
+#include "rng.h"
+#include "stats.h"
+#include "trace.h"
+
+/** interval of the timer in milliseconds, while graph updates are polled */
+#define UPDATE_TICK_MS (50)
+
+/** maximum length of a line on the update channel */
+#define UPDATE_LINE_LEN (4096)
 
 /** the program name */
 static const char *program_name;
 
+/**
+ * @brief the options passed to this program.
+ */
+typedef struct options {
+    int limit;
+    int delay;
+    const char *metrics;
+    int interval;
+    const char *graph;
+    const char *socket;
+    int workers;
+    const char *updates;
+    const char *listen;
+    unsigned long long seed;
+} options;
+
+/**
+ * @brief the channel, graph updates are read from, and the line read so far.
+ */
+typedef struct update_channel {
+    int fd;
+    size_t len;
+    char line[UPDATE_LINE_LEN];
+} update_channel;
+
 volatile sig_atomic_t quit = 0;
 
+/** set, when the stats shall be written to the metrics file */
+volatile sig_atomic_t dump = 0;
+
+/** set on every expiry of the timer */
+volatile sig_atomic_t tick = 0;
+
 /**
  * @brief signal handler to receive a SIGINT or SIGTERM signal
  *
@@ -28,6 +76,39 @@ static void handle_signal(int signal) {
     quit = 1;
 }
 
+/**
+ * @brief signal handler to receive a SIGUSR1 signal, requesting a stats dump
+ *
+ * @param signal
+ */
+static void handle_dump(int signal) {
+    dump = 1;
+}
+
+/**
+ * @brief signal handler to receive the SIGALRM signal of the timer
+ *
+ * @param signal
+ */
+static void handle_tick(int signal) {
+    tick = 1;
+}
+
+/**
+ * @brief Waits for the specified number of seconds, or until SIGINT or SIGTERM is received.
+ *
+ * @details Other signals, e.g. the ticks of the timer, do not shorten the delay, the remaining time
+ * is waited for again.
+ *
+ * @param seconds the delay in seconds
+ */
+static void wait_delay(int seconds) {
+    struct timespec remaining = {.tv_sec = seconds, .tv_nsec = 0};
+
+    while (!quit && nanosleep(&remaining, &remaining) == -1 && errno == EINTR) {
+    }
+}
+
 /**
  * @brief Prints an error message to stderr, and terminates the program
  * with EXIT_FAILURE.
@@ -44,7 +125,7 @@ static void error_and_exit(char *message) {
  * with EXIT_FAILURE.
  */
 static void usage(void) {
-    fprintf(stderr, "usage: %s [-n limit] [-w delay] [-p]\n", program_name);
+    fprintf(stderr, "usage: %s [-n limit] [-w delay] [-p] [-m metrics] [-i interval] [-g graph [-u updates]] [-l address] [-s seed] [-d socket [-j workers]]\n", program_name);
     exit(EXIT_FAILURE);
 }
 
@@ -52,17 +133,24 @@ static void usage(void) {
  * @brief parses the arguments passed to this program.
  * [-n limit] specifies the limit for generated solutions
  * [-w delay] specifies the delay before this program starts to read from the circular buffer.
+ * [-m metrics] specifies the file, the stats are written to on SIGUSR1 or every interval.
+ * [-i interval] specifies the interval in seconds, in which the stats are written.
+ * [-g graph] specifies a file, the graph is read from and published to the generators.
+ * [-u updates] specifies a fifo, edge insertions "+u-v" and deletions "-u-v" of the graph are read from.
+ * [-l address] accepts generators on other hosts at "tcp://host:port" or "unix:/path".
+ * [-s seed] specifies the seed of the random streams of the generators, drawn from the clock otherwise.
+ * [-d socket] runs the solver service on the specified unix domain socket, instead of a single graph.
+ * [-j workers] specifies the number of worker processes of the solver service.
  *
  * @param argc argument counter
  * @param argv argument values
- * @param limit pointer to variable, which stores the specified limit for generated solutions
- * @param delay pointer to variable, which stores the specified delay in seconds
+ * @param opts pointer to the options, which store the parsed arguments
  */
-static void parse_args(int argc, char **argv, int *limit, int *delay) {
+static void parse_args(int argc, char **argv, options *opts) {
 
     int option_index;
 
-    while ((option_index = getopt(argc, argv, "n:w:")) != -1) {
+    while ((option_index = getopt(argc, argv, "n:w:m:i:g:u:l:s:d:j:")) != -1) {
 
         switch (option_index) {
             case 'n': {
@@ -76,7 +164,7 @@ static void parse_args(int argc, char **argv, int *limit, int *delay) {
                     usage();
                 }
 
-                *limit = (int) lim;
+                opts->limit = (int) lim;
 
                 break;
             }
@@ -91,7 +179,65 @@ static void parse_args(int argc, char **argv, int *limit, int *delay) {
                     usage();
                 }
 
-                *delay = (int) del;
+                opts->delay = (int) del;
+
+                break;
+            }
+            case 'm':
+                opts->metrics = optarg;
+                break;
+            case 'i': {
+                char *endptr;
+                long ival = strtol(optarg, &endptr, 10);
+
+                if (endptr[0] != '\0') {
+                    usage();
+                }
+                if (ival <= 0) {
+                    usage();
+                }
+
+                opts->interval = (int) ival;
+
+                break;
+            }
+            case 'g':
+                opts->graph = optarg;
+                break;
+            case 'u':
+                opts->updates = optarg;
+                break;
+            case 'l':
+                opts->listen = optarg;
+                break;
+            case 's': {
+                char *endptr;
+                errno = 0;
+                unsigned long long seed = strtoull(optarg, &endptr, 0);
+
+                if (endptr == optarg || endptr[0] != '\0' || errno != 0) {
+                    usage();
+                }
+
+                opts->seed = seed;
+
+                break;
+            }
+            case 'd':
+                opts->socket = optarg;
+                break;
+            case 'j': {
+                char *endptr;
+                long wrk = strtol(optarg, &endptr, 10);
+
+                if (endptr[0] != '\0') {
+                    usage();
+                }
+                if (wrk <= 0) {
+                    usage();
+                }
+
+                opts->workers = (int) wrk;
 
                 break;
             }
@@ -103,6 +249,213 @@ static void parse_args(int argc, char **argv, int *limit, int *delay) {
                 break;
         }
     }
+
+    if (opts->updates != NULL && opts->graph == NULL) {
+        usage();
+    }
+}
+
+/**
+ * @brief writes the stats of the generators and the circular buffer to the metrics file.
+ *
+ * @param cb the circular buffer
+ * @param pool the elite pool
+ * @param metrics path of the metrics file
+ * @param read number of solutions read
+ * @param improved number of solutions, which improved the best solution
+ * @param best number of edges of the best solution, INT_MAX if there is none
+ */
+static void dump_stats(circular_buffer *cb, elite_pool *pool, const char *metrics, unsigned long long read,
+                       unsigned long long improved, int best) {
+    int producers = 0;
+    for (int i = 0; i < MAX_PRODUCERS; i++) {
+        producers += __atomic_load_n(&cb->stats[i].active, __ATOMIC_RELAXED);
+    }
+    ring_stats rs = {
+            .capacity = MAX_DATA,
+            .fill = circular_buffer_fill(cb),
+            .producers = producers,
+            .read = read,
+            .improved = improved,
+            .best = best == INT_MAX ? -1 : best
+    };
+    elite_pool_stats(pool, &rs);
+
+    if (stats_dump(metrics, cb->stats, MAX_PRODUCERS, &rs) == -1) {
+        fprintf(stderr, "%s: error writing metrics to %s\n", program_name, metrics);
+    }
+}
+
+/**
+ * @brief reduces the graph to its kernel and publishes the kernel to the generators, as the next
+ * generation of old, if given.
+ *
+ * @param g the graph
+ * @param old the currently published graph, or NULL
+ * @param full pointer to the full representation of the graph, used to validate solutions, which is replaced
+ * @return the published kernel
+ */
+static graph_shm *publish_kernel(graph *g, graph_shm *old, graph_shm **full) {
+    graph_lift lift = graph_lift_constr();
+    graph kernel = graph_kernelize(g, &lift);
+
+    graph_shm *gs = old == NULL ? graph_shm_publish(&kernel, &lift, NULL) : graph_shm_update(old, &kernel, &lift);
+    free(*full);
+    *full = graph_shm_build(g, NULL);
+
+    if (gs->generation == 0) {
+        fprintf(stderr, "Graph with %d vertices, %d edges and %d strongly connected components\n",
+                (*full)->size_v, (*full)->size_e, (*full)->size_scc);
+    } else {
+        fprintf(stderr, "Graph generation %d with %d vertices, %d edges and %d strongly connected components\n",
+                gs->generation, (*full)->size_v, (*full)->size_e, (*full)->size_scc);
+    }
+    fprintf(stderr, "Kernel with %d vertices, %d edges and %d strongly connected components, "
+                    "%d edges forced by %d reductions\n",
+            gs->size_v, gs->size_e, gs->size_scc, gs->size_forced, gs->size_lift);
+
+    graph_destr(&kernel);
+    graph_lift_destr(&lift);
+
+    return gs;
+}
+
+/**
+ * @brief reads the graph from the specified file and publishes its kernel to the generators.
+ *
+ * @param path path of the graph file
+ * @param g the graph, where the edges are added to
+ * @param full pointer to the full representation of the graph, used to validate solutions
+ * @return the published kernel
+ */
+static graph_shm *publish_graph(const char *path, graph *g, graph_shm **full) {
+    FILE *input = fopen(path, "r");
+    if (input == NULL) {
+        error_and_exit("cannot open graph file");
+    }
+
+    if (graph_read(g, input) == -1) {
+        fclose(input);
+        error_and_exit("malformed graph file");
+    }
+    fclose(input);
+
+    return publish_kernel(g, NULL, full);
+}
+
+/**
+ * @brief applies a single update "+u-v" or "-u-v" to the graph and the best solution.
+ *
+ * @details An inserted edge is added to inserted, so the best solution can be repaired once the
+ * new generation is published. A deleted edge is removed from the best solution right away.
+ *
+ * @param token the update
+ * @param g the graph
+ * @param best the best solution, size_e is INT_MAX if there is none
+ * @param inserted the edges inserted since the last publication
+ * @return 1 if the graph changed, 0 if not, -1 on a malformed update
+ */
+static int apply_update(const char *token, graph *g, graph *best, graph *inserted) {
+    char op;
+    int u, v, off = 0;
+
+    if (sscanf(token, "%c%d-%d%n", &op, &u, &v, &off) != 3 || token[off] != '\0' || u < 0 || v < 0) {
+        return -1;
+    }
+
+    edge e = edge_constr(u, v);
+
+    if (op == '+') {
+        if (graph_contains_edge(g, &e)) {
+            return 0;
+        }
+        graph_add(g, &e);
+        graph_add(inserted, &e);
+        return 1;
+    }
+    if (op == '-') {
+        if (best->size_e != INT_MAX) {
+            graph_remove(best, &e);
+        }
+        graph_remove(inserted, &e);
+        return graph_remove(g, &e);
+    }
+    return -1;
+}
+
+/**
+ * @brief reads the available updates from the update channel and applies every complete line.
+ *
+ * @param uc the update channel
+ * @param g the graph
+ * @param best the best solution, size_e is INT_MAX if there is none
+ * @param inserted the edges inserted since the last publication
+ * @return the number of changes to the graph
+ */
+static int read_updates(update_channel *uc, graph *g, graph *best, graph *inserted) {
+    int changes = 0;
+    ssize_t r;
+
+    while ((r = read(uc->fd, uc->line + uc->len, UPDATE_LINE_LEN - 1 - uc->len)) > 0) {
+        uc->len += (size_t) r;
+        uc->line[uc->len] = '\0';
+
+        char *end;
+        while ((end = strchr(uc->line, '\n')) != NULL) {
+            *end = '\0';
+            for (char *token = strtok(uc->line, " \t\r"); token != NULL; token = strtok(NULL, " \t\r")) {
+                int changed = apply_update(token, g, best, inserted);
+                if (changed == -1) {
+                    fprintf(stderr, "%s: ignoring malformed update %s\n", program_name, token);
+                } else {
+                    changes += changed;
+                }
+            }
+            uc->len -= (size_t) (end + 1 - uc->line);
+            memmove(uc->line, end + 1, uc->len + 1);
+        }
+
+        if (uc->len == UPDATE_LINE_LEN - 1) {
+            fprintf(stderr, "%s: discarding overlong update line\n", program_name);
+            uc->len = 0;
+        }
+    }
+
+    return changes;
+}
+
+/**
+ * @brief publishes the next generation of the graph and repairs the best solution.
+ *
+ * @details The best solution has already lost the deleted edges. If it is no longer a feedback arc set
+ * because of inserted edges, these are added to it, which always restores a feedback arc set.
+ *
+ * @param gs the currently published graph
+ * @param g the changed graph
+ * @param best the best solution, size_e is INT_MAX if there is none
+ * @param inserted the edges inserted since the last publication, emptied by this function
+ * @param full pointer to the full representation of the graph, which is replaced
+ * @return the newly published graph
+ */
+static graph_shm *publish_update(graph_shm *gs, graph *g, graph *best, graph *inserted, graph_shm **full) {
+    gs = publish_kernel(g, gs, full);
+
+    if (best->size_e != INT_MAX && graph_shm_is_fas(*full, best) == 0) {
+        for (int j = 0; j < inserted->size_e; j++) {
+            if (!graph_contains_edge(best, &inserted->edges[j])) {
+                graph_add(best, &inserted->edges[j]);
+            }
+        }
+    }
+    graph_destr(inserted);
+    *inserted = graph_constr();
+
+    if (best->size_e != INT_MAX) {
+        fprintf(stderr, "Updated solution with %d edges: ", best->size_e);
+        graph_print(best, stderr);
+    }
+
+    return gs;
 }
 
 /**
@@ -115,51 +468,156 @@ static void parse_args(int argc, char **argv, int *limit, int *delay) {
  */
 int main(int argc, char **argv) {
     program_name = argv[0];
-    int limit = -1;
-    int delay = 0;
+    options opts = {.limit = -1, .delay = 0, .metrics = NULL, .interval = 0, .graph = NULL,
+                    .socket = NULL, .workers = (int) sysconf(_SC_NPROCESSORS_ONLN), .updates = NULL, .listen = NULL,
+                    .seed = rng_default_seed()};
+
+    parse_args(argc, argv, &opts);
 
-    parse_args(argc, argv, &limit, &delay);
+    TRACE_INIT("supervisor");
+
+    if (opts.socket != NULL) {
+        return service_run(opts.socket, opts.workers > 0 ? opts.workers : 1, opts.seed);
+    }
+
+    profile_init("supervisor");
 
     struct sigaction sa = {.sa_handler = handle_signal};
     sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (opts.metrics != NULL) {
+        struct sigaction sa_dump = {.sa_handler = handle_dump};
+        sigaction(SIGUSR1, &sa_dump, NULL);
+    }
 
-    circular_buffer *cb = circular_buffer_setup(1);
+    int timed = opts.updates != NULL || (opts.metrics != NULL && opts.interval > 0);
+    if (timed) {
+        struct sigaction sa_tick = {.sa_handler = handle_tick};
+        sigaction(SIGALRM, &sa_tick, NULL);
+    }
+
+    graph input = graph_constr();
+    graph_shm *full = NULL;
+    graph_shm *gs = opts.graph != NULL ? publish_graph(opts.graph, &input, &full) : NULL;
+
+    update_channel uc = {.fd = -1, .len = 0};
+    graph inserted = graph_constr();
+    if (opts.updates != NULL && (uc.fd = open(opts.updates, O_RDONLY | O_NONBLOCK)) == -1) {
+        error_and_exit("cannot open update channel");
+    }
+
+    circular_buffer *cb = circular_buffer_setup(1, NULL, opts.seed);
+    elite_pool *pool = elite_pool_setup(NULL);
+    if (opts.listen != NULL) {
+        circular_buffer_listen(cb, opts.listen, NULL);
+    }
+    fprintf(stderr, "Seed %llu\n", opts.seed);
 
 
     graph best = graph_constr();
     best.size_e = INT_MAX;
 
-    sleep(delay);
+    unsigned long long read = 0;
+    unsigned long long improved = 0;
+    int solved = 0;
+
+    if (gs != NULL && gs->size_e == 0 && uc.fd == -1) {
+        best.size_e = 0;
+        graph_lift_solution(&best, graph_shm_lift(gs), gs->size_lift);
+        fprintf(stderr, "Solution with %d edges, found by the reductions: ", best.size_e);
+        graph_print(&best, stderr);
+        solved = 1;
+    }
+
+    wait_delay(opts.delay);
+
+    unsigned long long next_dump = stats_now_ns() + (unsigned long long) opts.interval * 1000000000ULL;
+    if (timed) {
+        struct timeval period = {.tv_sec = opts.interval};
+        if (opts.updates != NULL) {
+            period.tv_sec = 0;
+            period.tv_usec = UPDATE_TICK_MS * 1000;
+        }
+        struct itimerval timer = {.it_interval = period, .it_value = period};
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
+
 
+    for (int i = 0; !quit && !solved && i != opts.limit; ++i) {
+
+        if (tick) {
+            tick = 0;
+            if (opts.metrics != NULL && opts.interval > 0 && stats_now_ns() >= next_dump) {
+                next_dump += (unsigned long long) opts.interval * 1000000000ULL;
+                dump = 1;
+            }
+            if (uc.fd != -1 && read_updates(&uc, &input, &best, &inserted) > 0) {
+                gs = publish_update(gs, &input, &best, &inserted, &full);
+                circular_buffer_set_bound(cb, best.size_e);
+            }
+        }
 
-    for (int i = 0; !quit && i != limit; ++i) {
+        if (dump) {
+            dump = 0;
+            dump_stats(cb, pool, opts.metrics, read, improved, best.size_e);
+        }
 
         graph g = graph_constr();
-        circular_buffer_read(cb, &g);
+        solution_origin origin;
+        if (circular_buffer_read(cb, &g, &origin) == -1) {
+            graph_destr(&g);
+            --i;
+            continue;
+        }
+        read++;
+        unsigned long long compared = full != NULL ? (unsigned long long) full->size_e : 0;
+        TRACE_BEGIN(compare);
+        profile_begin(PROFILE_COMPARE);
+
+        if (full != NULL && g.size_e < best.size_e && graph_shm_is_fas(full, &g) == 0) {
+            fprintf(stderr, "Discarding invalid solution with %d edges: ", g.size_e);
+            graph_print(&g, stderr);
+            graph_destr(&g);
+            profile_end(PROFILE_COMPARE, compared);
+            TRACE_END(compare, "compare");
+            continue;
+        }
 
-        if (g.size_e == 0) {
+        if (g.size_e == 0 && uc.fd == -1) {
             graph_destr(&best);
             best = graph_constr();
             for (int j = 0; j < g.size_e; j++) {
                 graph_add(&best, &g.edges[j]);
             }
+            profile_end(PROFILE_COMPARE, compared);
+            TRACE_END(compare, "compare");
             break;
         }
 
         if (g.size_e < best.size_e) {
+            improved++;
             graph_destr(&best);
             best = graph_constr();
             for (int j = 0; j < g.size_e; j++) {
                 graph_add(&best, &g.edges[j]);
             }
-            fprintf(stderr, "Solution with %d edges: ", best.size_e);
+            circular_buffer_set_bound(cb, best.size_e);
+            fprintf(stderr, "Solution with %d edges (worker %d, iteration %llu): ", best.size_e,
+                    origin.worker, origin.iteration);
             graph_print(&best, stderr);
         }
+        profile_end(PROFILE_COMPARE, compared);
+        TRACE_END(compare, "compare");
 
         graph_destr(&g);
     }
 
-    cb->terminate = 1;
+    circular_buffer_terminate(cb);
+
+    if (opts.metrics != NULL) {
+        dump_stats(cb, pool, opts.metrics, read, improved, best.size_e);
+    }
 
     if (best.size_e == 0) {
         fprintf(stdout, "The graph is acyclic!\n");
@@ -168,6 +626,17 @@ int main(int argc, char **argv) {
     }
 
     circular_buffer_destr(cb, 1);
+    elite_pool_destr(pool, 1);
+
+    if (gs != NULL) {
+        graph_shm_destr(gs, 1);
+    }
+    free(full);
+    if (uc.fd != -1) {
+        close(uc.fd);
+    }
+    graph_destr(&input);
+    graph_destr(&inserted);
     //graph_destr(&best);
 
     return EXIT_SUCCESS;
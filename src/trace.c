@@ -0,0 +1,153 @@
+/**
+ * @file trace.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The timeline tracing of the hot path phases, written in the Chrome trace JSON array format.
+ */
+
+#include "trace.h"
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief a recorded span, name points to a string literal.
+ */
+typedef struct trace_event {
+    const char *name;
+    unsigned long long start;
+    unsigned long long end;
+} trace_event;
+
+/**
+ * the buffer of this process, NULL if tracing is not enabled
+ */
+static trace_event *events = NULL;
+static int capacity = 0;
+static int size = 0;
+static unsigned long long dropped = 0;
+
+/**
+ * the trace file and the name of this process
+ */
+static const char *path = NULL;
+static const char *process_name = NULL;
+
+/**
+ * set, once trace_flush is registered with atexit(3)
+ */
+static int registered = 0;
+
+/**
+ * @brief This function enables tracing for the calling process, if FB_TRACE is set.
+ *
+ * @details Spans recorded by the parent before a fork are discarded, so a forked child calls this
+ * function again. The spans are flushed at exit, processes leaving by _exit(2) call trace_flush first.
+ *
+ * @param name the name of the process in the timeline
+ */
+void trace_init(const char *name) {
+    path = getenv(TRACE_ENV);
+    process_name = name;
+    size = 0;
+    dropped = 0;
+
+    if (path == NULL || path[0] == '\0') {
+        path = NULL;
+        return;
+    }
+
+    if (events == NULL) {
+        const char *cap = getenv(TRACE_CAPACITY_ENV);
+        capacity = cap != NULL && atoi(cap) > 0 ? atoi(cap) : TRACE_CAPACITY;
+        events = malloc(sizeof(trace_event) * capacity);
+        if (events == NULL) {
+            fprintf(stderr, "trace: error allocating %d events, tracing disabled\n", capacity);
+            path = NULL;
+            return;
+        }
+    }
+
+    if (!registered) {
+        atexit(trace_flush);
+        registered = 1;
+    }
+}
+
+/**
+ * @brief This function records a span.
+ *
+ * @details Does nothing, if tracing is not enabled. If the buffer is full, the span is dropped and counted.
+ *
+ * @param name the name of the phase, a string literal
+ * @param start start of the span, as returned by stats_now_ns
+ * @param end end of the span, as returned by stats_now_ns
+ */
+void trace_span(const char *name, unsigned long long start, unsigned long long end) {
+    if (path == NULL) {
+        return;
+    }
+    if (size == capacity) {
+        dropped++;
+        return;
+    }
+
+    trace_event *e = &events[size++];
+    e->name = name;
+    e->start = start;
+    e->end = end;
+}
+
+/**
+ * @brief This function appends the recorded spans to the trace file and empties the buffer.
+ *
+ * @details The file is locked while appending, so the spans of concurrently exiting processes do not
+ * interleave. The first writer opens the JSON array, which is never closed, as the format allows.
+ */
+void trace_flush(void) {
+    if (path == NULL || (size == 0 && dropped == 0)) {
+        return;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd == -1) {
+        return;
+    }
+    flock(fd, LOCK_EX);
+
+    FILE *out = fdopen(fd, "a");
+    if (out == NULL) {
+        close(fd);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size == 0) {
+        fprintf(out, "[\n");
+    }
+
+    int pid = (int) getpid();
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}},\n",
+            pid, pid, process_name != NULL ? process_name : "process", pid);
+
+    for (int i = 0; i < size; i++) {
+        fprintf(out, "{\"name\":\"%s\",\"cat\":\"fb\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+                events[i].name, pid, pid, events[i].start / 1000.0, (events[i].end - events[i].start) / 1000.0);
+    }
+
+    if (dropped > 0) {
+        fprintf(out, "{\"name\":\"trace_dropped\",\"ph\":\"i\",\"s\":\"p\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,"
+                     "\"args\":{\"spans\":%llu}},\n",
+                pid, pid, stats_now_ns() / 1000.0, dropped);
+    }
+
+    fflush(out);
+    flock(fd, LOCK_UN);
+    fclose(out);
+
+    size = 0;
+    dropped = 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file trace.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the timeline tracing of the hot path phases, implemented by @file trace.c
+ *
+ * @details Tracing is compiled out, unless the programs are built with -DTRACE (make TRACE=1), then the
+ * TRACE_ macros record spans into a buffer owned by the calling process, which needs no locking.
+ * At runtime tracing is only enabled, if the environment variable FB_TRACE names the trace file.
+ * Every process appends its spans to this file at exit, as events of the Chrome trace JSON array format,
+ * so all processes show up in one timeline (chrome://tracing or ui.perfetto.dev).
+ * Timestamps are taken from the monotonic clock, which is common to all processes of a host.
+ */
+
+#ifndef FB_ARC_SET_TRACE_H
+#define FB_ARC_SET_TRACE_H
+
+#include "stats.h"
+
+/**
+ * environment variables naming the trace file, and the capacity of the buffer in spans
+ */
+#define TRACE_ENV "FB_TRACE"
+#define TRACE_CAPACITY_ENV "FB_TRACE_EVENTS"
+#define TRACE_CAPACITY (262144)
+
+#ifdef TRACE
+#define TRACE_INIT(name) trace_init(name)
+#define TRACE_FLUSH() trace_flush()
+#define TRACE_BEGIN(var) unsigned long long var = stats_now_ns()
+#define TRACE_END(var, name) trace_span(name, var, stats_now_ns())
+#define TRACE_SPAN(name, start, end) trace_span(name, start, end)
+#else
+#define TRACE_INIT(name)
+#define TRACE_FLUSH()
+#define TRACE_BEGIN(var)
+#define TRACE_END(var, name)
+#define TRACE_SPAN(name, start, end)
+#endif
+
+/**
+ * @brief This function enables tracing for the calling process, if FB_TRACE is set.
+ *
+ * @details Spans recorded by the parent before a fork are discarded, so a forked child calls this
+ * function again. The spans are flushed at exit, processes leaving by _exit(2) call trace_flush first.
+ *
+ * @param name the name of the process in the timeline
+ */
+void trace_init(const char *name);
+
+/**
+ * @brief This function records a span.
+ *
+ * @details Does nothing, if tracing is not enabled. If the buffer is full, the span is dropped and counted.
+ *
+ * @param name the name of the phase, a string literal
+ * @param start start of the span, as returned by stats_now_ns
+ * @param end end of the span, as returned by stats_now_ns
+ */
+void trace_span(const char *name, unsigned long long start, unsigned long long end);
+
+/**
+ * @brief This function appends the recorded spans to the trace file and empties the buffer.
+ */
+void trace_flush(void);
+
+#endif //FB_ARC_SET_TRACE_H
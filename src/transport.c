@@ -0,0 +1,305 @@
+/**
+ * @file transport.c
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The socket transport of the circular buffer, connecting generators on other hosts.
+ */
+
+#include "transport.h"
+#include <errno.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+ * address prefixes of the supported socket families
+ */
+#define TCP_PREFIX "tcp://"
+#define UNIX_PREFIX "unix:"
+
+/**
+ * @brief Fills a unix domain socket address.
+ *
+ * @param addr the address to be filled
+ * @param path path of the socket
+ * @return 0 on success, -1 if the path is too long
+ */
+static int unix_address(struct sockaddr_un *addr, const char *path) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+/**
+ * @brief Resolves a TCP address of the form "host:port".
+ *
+ * @param hostport the address without prefix, an empty host means any address
+ * @param passive specifies, whether the address is used for listening (1) or connecting (0)
+ * @return the resolved addresses, to be released by freeaddrinfo(3), or NULL on error
+ */
+static struct addrinfo *tcp_address(const char *hostport, int passive) {
+    const char *colon = strrchr(hostport, ':');
+    char host[256];
+
+    if (colon == NULL || (size_t) (colon - hostport) >= sizeof(host)) {
+        return NULL;
+    }
+    memcpy(host, hostport, colon - hostport);
+    host[colon - hostport] = '\0';
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(host[0] != '\0' ? host : NULL, colon + 1, &hints, &res) != 0) {
+        return NULL;
+    }
+    return res;
+}
+
+/**
+ * @brief This function creates a socket listening on the specified address.
+ *
+ * @details A stale unix domain socket at the same path is removed first.
+ *
+ * @param address the address, "tcp://host:port" or "unix:/path"
+ * @return the listening socket, or -1 on error
+ */
+int transport_listen(const char *address) {
+    if (strncmp(address, UNIX_PREFIX, strlen(UNIX_PREFIX)) == 0) {
+        struct sockaddr_un addr;
+        if (unix_address(&addr, address + strlen(UNIX_PREFIX)) == -1) {
+            return -1;
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            return -1;
+        }
+        unlink(addr.sun_path);
+        if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1 || listen(fd, SOMAXCONN) == -1) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    if (strncmp(address, TCP_PREFIX, strlen(TCP_PREFIX)) == 0) {
+        struct addrinfo *res = tcp_address(address + strlen(TCP_PREFIX), 1);
+        int fd = -1;
+
+        for (struct addrinfo *ai = res; ai != NULL && fd == -1; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd == -1) {
+                continue;
+            }
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) == -1 || listen(fd, SOMAXCONN) == -1) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (res != NULL) {
+            freeaddrinfo(res);
+        }
+        return fd;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+/**
+ * @brief This function connects to the specified address.
+ *
+ * @param address the address, "tcp://host:port" or "unix:/path"
+ * @return the connected socket, or -1 on error
+ */
+int transport_connect(const char *address) {
+    if (strncmp(address, UNIX_PREFIX, strlen(UNIX_PREFIX)) == 0) {
+        struct sockaddr_un addr;
+        if (unix_address(&addr, address + strlen(UNIX_PREFIX)) == -1) {
+            return -1;
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            return -1;
+        }
+        if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    if (strncmp(address, TCP_PREFIX, strlen(TCP_PREFIX)) == 0) {
+        struct addrinfo *res = tcp_address(address + strlen(TCP_PREFIX), 0);
+        int fd = -1;
+
+        for (struct addrinfo *ai = res; ai != NULL && fd == -1; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd == -1) {
+                continue;
+            }
+            if (connect(fd, ai->ai_addr, ai->ai_addrlen) == -1) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (res != NULL) {
+            freeaddrinfo(res);
+        }
+        if (fd != -1) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        return fd;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+/**
+ * @brief This function removes the unix domain socket of the specified address, if any.
+ *
+ * @param address the address, "tcp://host:port" or "unix:/path"
+ */
+void transport_unlink(const char *address) {
+    if (strncmp(address, UNIX_PREFIX, strlen(UNIX_PREFIX)) == 0) {
+        unlink(address + strlen(UNIX_PREFIX));
+    }
+}
+
+/**
+ * @brief This function sends a frame.
+ *
+ * @param fd the socket
+ * @param type the frame type
+ * @param payload the payload
+ * @param len length of the payload, at most FRAME_MAX - 1
+ * @return 0 on success, -1 if the connection failed
+ */
+int transport_send(int fd, int type, const unsigned char *payload, size_t len) {
+    unsigned char frame[4 + FRAME_MAX];
+
+    if (len + 1 > FRAME_MAX) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    transport_put32(frame, (unsigned int) (len + 1));
+    frame[4] = (unsigned char) type;
+    if (len > 0) {
+        memcpy(frame + 5, payload, len);
+    }
+
+    size_t sent = 0;
+    while (sent < len + 5) {
+        ssize_t s = send(fd, frame + sent, len + 5 - sent, MSG_NOSIGNAL);
+        if (s == -1 && errno == EINTR) {
+            continue;
+        }
+        if (s <= 0) {
+            return -1;
+        }
+        sent += (size_t) s;
+    }
+    return 0;
+}
+
+/**
+ * @brief This function reads the available bytes from the socket into the frame buffer.
+ *
+ * @param fd the socket
+ * @param fb the frame buffer
+ * @param wait specifies, whether to block until data is available (1) or not (0)
+ * @return 0 on success, also if nothing is available, -1 if the connection was closed or failed
+ */
+int transport_recv(int fd, frame_buffer *fb, int wait) {
+    if (fb->len == sizeof(fb->data)) {
+        return 0;
+    }
+
+    ssize_t r = recv(fd, fb->data + fb->len, sizeof(fb->data) - fb->len, wait ? 0 : MSG_DONTWAIT);
+
+    if (r == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return 0;
+    }
+    if (r <= 0) {
+        return -1;
+    }
+    fb->len += (size_t) r;
+    return 0;
+}
+
+/**
+ * @brief This function takes the next complete frame out of the frame buffer.
+ *
+ * @param fb the frame buffer
+ * @param type pointer to variable, which stores the frame type
+ * @param payload buffer of FRAME_MAX bytes, which stores the payload
+ * @param len pointer to variable, which stores the length of the payload
+ * @return 1 if a frame was taken, 0 if no complete frame is buffered, -1 on a malformed frame
+ */
+int transport_next(frame_buffer *fb, int *type, unsigned char *payload, size_t *len) {
+    if (fb->len < 4) {
+        return 0;
+    }
+
+    size_t size = transport_get32(fb->data);
+    if (size == 0 || size > FRAME_MAX) {
+        return -1;
+    }
+    if (fb->len < 4 + size) {
+        return 0;
+    }
+
+    *type = fb->data[4];
+    *len = size - 1;
+    memcpy(payload, fb->data + 5, size - 1);
+
+    fb->len -= 4 + size;
+    memmove(fb->data, fb->data + 4 + size, fb->len);
+    return 1;
+}
+
+/**
+ * @brief This function stores an unsigned 32 bit integer in network byte order.
+ *
+ * @param p the destination
+ * @param value the value
+ */
+void transport_put32(unsigned char *p, unsigned int value) {
+    p[0] = (unsigned char) (value >> 24);
+    p[1] = (unsigned char) (value >> 16);
+    p[2] = (unsigned char) (value >> 8);
+    p[3] = (unsigned char) value;
+}
+
+/**
+ * @brief This function loads an unsigned 32 bit integer in network byte order.
+ *
+ * @param p the source
+ * @return the value
+ */
+unsigned int transport_get32(const unsigned char *p) {
+    return ((unsigned int) p[0] << 24) | ((unsigned int) p[1] << 16) | ((unsigned int) p[2] << 8) | p[3];
+}
@@ -0,0 +1,121 @@
+/**
+ * @file transport.h
+ * @author Kristijan Todorovic, [e11806442(at)student.tuwien.ac.at]
+ * @date 19.10.2026
+ *
+ * @brief The header file for the socket transport of the circular buffer, implemented by @file transport.c
+ *
+ * @details Generators on other hosts connect to the supervisor over TCP ("tcp://host:port") or a unix domain
+ * socket ("unix:/path"). All messages are frames, consisting of a 4 byte length in network byte order,
+ * followed by a 1 byte type and the payload, whose integers are also in network byte order:
+ *
+ *     FRAME_SOLUTIONS  generated (4), dropped (4), count (2), count times: size (1), iteration (8),
+ *                      size times: u (4), v (4)
+ *     FRAME_BOUND      bound (4), the size of the best solution known to the supervisor
+ *     FRAME_TERMINATE  no payload
+ *     FRAME_HELLO      seed (8), worker (4), the random stream of the generator (see rng.h)
+ *
+ * Solutions are sent by the generator in batches, bound and terminate are broadcast by the supervisor.
+ * The hello is the first frame the supervisor sends on a connection.
+ */
+
+#ifndef FB_ARC_SET_TRANSPORT_H
+#define FB_ARC_SET_TRANSPORT_H
+
+#include <stddef.h>
+
+/**
+ * frame types
+ */
+#define FRAME_SOLUTIONS (1)
+#define FRAME_BOUND (2)
+#define FRAME_TERMINATE (3)
+#define FRAME_HELLO (4)
+
+/**
+ * maximum size of a frame, without its length
+ */
+#define FRAME_MAX (2048)
+
+/**
+ * @brief a buffer of received bytes, which may contain several or partial frames.
+ */
+typedef struct frame_buffer {
+    size_t len;
+    unsigned char data[4 + FRAME_MAX];
+} frame_buffer;
+
+/**
+ * @brief This function creates a socket listening on the specified address.
+ *
+ * @details A stale unix domain socket at the same path is removed first.
+ *
+ * @param address the address, "tcp://host:port" or "unix:/path"
+ * @return the listening socket, or -1 on error
+ */
+int transport_listen(const char *address);
+
+/**
+ * @brief This function connects to the specified address.
+ *
+ * @param address the address, "tcp://host:port" or "unix:/path"
+ * @return the connected socket, or -1 on error
+ */
+int transport_connect(const char *address);
+
+/**
+ * @brief This function removes the unix domain socket of the specified address, if any.
+ *
+ * @param address the address, "tcp://host:port" or "unix:/path"
+ */
+void transport_unlink(const char *address);
+
+/**
+ * @brief This function sends a frame.
+ *
+ * @param fd the socket
+ * @param type the frame type
+ * @param payload the payload
+ * @param len length of the payload, at most FRAME_MAX - 1
+ * @return 0 on success, -1 if the connection failed
+ */
+int transport_send(int fd, int type, const unsigned char *payload, size_t len);
+
+/**
+ * @brief This function reads the available bytes from the socket into the frame buffer.
+ *
+ * @param fd the socket
+ * @param fb the frame buffer
+ * @param wait specifies, whether to block until data is available (1) or not (0)
+ * @return 0 on success, also if nothing is available, -1 if the connection was closed or failed
+ */
+int transport_recv(int fd, frame_buffer *fb, int wait);
+
+/**
+ * @brief This function takes the next complete frame out of the frame buffer.
+ *
+ * @param fb the frame buffer
+ * @param type pointer to variable, which stores the frame type
+ * @param payload buffer of FRAME_MAX bytes, which stores the payload
+ * @param len pointer to variable, which stores the length of the payload
+ * @return 1 if a frame was taken, 0 if no complete frame is buffered, -1 on a malformed frame
+ */
+int transport_next(frame_buffer *fb, int *type, unsigned char *payload, size_t *len);
+
+/**
+ * @brief This function stores an unsigned 32 bit integer in network byte order.
+ *
+ * @param p the destination
+ * @param value the value
+ */
+void transport_put32(unsigned char *p, unsigned int value);
+
+/**
+ * @brief This function loads an unsigned 32 bit integer in network byte order.
+ *
+ * @param p the source
+ * @return the value
+ */
+unsigned int transport_get32(const unsigned char *p);
+
+#endif //FB_ARC_SET_TRANSPORT_H